@@ -18,19 +18,28 @@
 #include "wrd-gpio-switch/DigitalInEx.h"
 #include "wrd-gpio-switch/GPIOSwitch.h"
 
+#include <new>
+
+#if YOTTA_CFG_WRD_GPIO_SWITCH_INPUT_MAX_AGE
+#define INPUT_MAX_AGE YOTTA_CFG_WRD_GPIO_SWITCH_INPUT_MAX_AGE
+#else
+#define INPUT_MAX_AGE 0
+#endif
+
 DigitalInEx::DigitalInEx(uint32_t _pin, uint32_t _location)
     :   pin(_pin),
         location(_location),
         cache(0),
-        local(NULL)
+        tracked(false),
+        maxAge(INPUT_MAX_AGE)
 {
     if (location)
     {
-        GPIOSwitch::setDirection(pin, location, 0);
+        GPIOSwitch::configureInput(pin, location);
     }
     else
     {
-        local = SharedPointer<DigitalIn>(new DigitalIn((PinName) pin));
+        new (localStorage) DigitalIn((PinName) pin);
     }
 }
 
@@ -38,15 +47,37 @@ DigitalInEx::DigitalInEx(uint32_t _pin, uint32_t _location, PinMode mode)
     :   pin(_pin),
         location(_location),
         cache(0),
-        local(NULL)
+        tracked(false),
+        maxAge(INPUT_MAX_AGE)
 {
     if (location)
     {
-        GPIOSwitch::setDirection(pin, location, 0);
+        GPIOSwitch::configureInput(pin, location);
     }
     else
     {
-        local = SharedPointer<DigitalIn>(new DigitalIn((PinName) pin, mode));
+        new (localStorage) DigitalIn((PinName) pin, mode);
+    }
+}
+
+DigitalInEx::DigitalInEx(const DigitalInEx& other)
+    :   pin(other.pin),
+        location(other.location),
+        cache(other.cache),
+        tracked(other.tracked),
+        maxAge(other.maxAge)
+{
+    if (location == 0)
+    {
+        new (localStorage) DigitalIn(*other.local());
+    }
+}
+
+DigitalInEx::~DigitalInEx()
+{
+    if (location == 0)
+    {
+        local()->~DigitalIn();
     }
 }
 
@@ -54,6 +85,31 @@ int DigitalInEx::read(void)
 {
     if (location)
     {
+        if (tracked)
+        {
+            int value = GPIOSwitch::readInputCached(pin, location);
+
+            /* no value before the first read has completed or after the
+               pin interrupt has been disabled, poll instead.
+            */
+            if (value >= 0)
+            {
+                return value;
+            }
+        }
+
+        if (maxAge)
+        {
+            int value = GPIOSwitch::readInputCached(pin, location, maxAge);
+
+            // shadow is recent enough, skip the bus read
+            if (value >= 0)
+            {
+                cache = value;
+                return value;
+            }
+        }
+
         // schedule cache to be updated
         FunctionPointer1<void, int> fp(this, &DigitalInEx::updateCache);
         GPIOSwitch::readInput(pin, location, fp);
@@ -62,23 +118,38 @@ int DigitalInEx::read(void)
     }
     else
     {
-        return local->read();
+        return local()->read();
     }
 }
 
-void DigitalInEx::read(FunctionPointer1<void, int> callback)
+void DigitalInEx::read(FunctionPointer1<void, int> callback, GPIOSwitch::priority_t priority)
 {
     if (location)
     {
-        GPIOSwitch::readInput(pin, location, callback);
+        GPIOSwitch::readInput(pin, location, callback, priority);
     }
     else
     {
-        minar::Scheduler::postCallback(callback.bind(local->read()))
+        minar::Scheduler::postCallback(callback.bind(local()->read()))
             .tolerance(1);
     }
 }
 
+bool DigitalInEx::track(void)
+{
+    if (location)
+    {
+        tracked = GPIOSwitch::trackInput(pin, location);
+    }
+
+    return tracked;
+}
+
+void DigitalInEx::setMaxAge(uint32_t _maxAge)
+{
+    maxAge = _maxAge;
+}
+
 void DigitalInEx::mode(PinMode pull)
 {
     if (location)
@@ -87,7 +158,7 @@ void DigitalInEx::mode(PinMode pull)
     }
     else
     {
-        local->mode(pull);
+        local()->mode(pull);
     }
 }
 
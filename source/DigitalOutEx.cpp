@@ -18,18 +18,19 @@
 #include "wrd-gpio-switch/DigitalOutEx.h"
 #include "wrd-gpio-switch/GPIOSwitch.h"
 
+#include <new>
+
 DigitalOutEx::DigitalOutEx(uint32_t _pin, uint32_t _location)
     :   pin(_pin),
         location(_location)
 {
     if (location)
     {
-        GPIOSwitch::writeOutputTask(pin, location, 0);
-        GPIOSwitch::setDirection(pin, location, 1);
+        GPIOSwitch::configureOutput(pin, location, 0);
     }
     else
     {
-        local = SharedPointer<DigitalOut>(new DigitalOut((PinName) pin));
+        new (localStorage) DigitalOut((PinName) pin);
     }
 }
 
@@ -39,12 +40,29 @@ DigitalOutEx::DigitalOutEx(uint32_t _pin, int value, uint32_t _location)
 {
     if (location)
     {
-        GPIOSwitch::writeOutputTask(pin, location, value);
-        GPIOSwitch::setDirection(pin, location, 1);
+        GPIOSwitch::configureOutput(pin, location, value);
     }
     else
     {
-        local = SharedPointer<DigitalOut>(new DigitalOut((PinName) pin, value));
+        new (localStorage) DigitalOut((PinName) pin, value);
+    }
+}
+
+DigitalOutEx::DigitalOutEx(const DigitalOutEx& other)
+    :   pin(other.pin),
+        location(other.location)
+{
+    if (location == 0)
+    {
+        new (localStorage) DigitalOut(*other.local());
+    }
+}
+
+DigitalOutEx::~DigitalOutEx()
+{
+    if (location == 0)
+    {
+        local()->~DigitalOut();
     }
 }
 
@@ -56,19 +74,19 @@ void DigitalOutEx::write(int value)
     }
     else
     {
-        local->write(value);
+        local()->write(value);
     }
 }
 
-void DigitalOutEx::write(int value, FunctionPointer0<void> callback)
+void DigitalOutEx::write(int value, FunctionPointer0<void> callback, GPIOSwitch::priority_t priority)
 {
     if (location)
     {
-        GPIOSwitch::writeOutput(pin, location, value, callback);
+        GPIOSwitch::writeOutput(pin, location, value, callback, priority);
     }
     else
     {
-        local->write(value);
+        local()->write(value);
         minar::Scheduler::postCallback(callback)
             .tolerance(1);
     }
@@ -82,6 +100,6 @@ int DigitalOutEx::read()
     }
     else
     {
-        return local->read();
+        return local()->read();
     }
 }
@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "wrd-gpio-switch/GPIOExpanderSimulator.h"
+
+#define SIMULATOR_MAX 8
+
+static GPIOExpanderSimulator* simulators[SIMULATOR_MAX] = { 0 };
+
+GPIOExpanderSimulator::GPIOExpanderSimulator(PinName, PinName, uint16_t _address, PinName _irq)
+    :   address(_address),
+        irq(_irq),
+        direction(0),
+        outputs(0),
+        inputs(0),
+        interruptMask(0),
+        latency(0),
+        busyInterval(0),
+        nackInterval(0),
+        requestCount(0),
+        commandCount(0),
+        command(COMMAND_NONE),
+        commandMask(0),
+        commandValue(0),
+        interruptPins(0)
+{
+    for (uint8_t index = 0; index < SIMULATOR_MAX; index++)
+    {
+        if (simulators[index] == NULL)
+        {
+            simulators[index] = this;
+            break;
+        }
+    }
+}
+
+GPIOExpanderSimulator* GPIOExpanderSimulator::find(uint16_t address)
+{
+    GPIOExpanderSimulator* result = NULL;
+
+    for (uint8_t index = 0; index < SIMULATOR_MAX; index++)
+    {
+        if (simulators[index] && (simulators[index]->address == address))
+        {
+            result = simulators[index];
+            break;
+        }
+    }
+
+    return result;
+}
+
+bool GPIOExpanderSimulator::bulkSetDirection(uint32_t mask, uint32_t _direction, FunctionPointer0<void> callback)
+{
+    bool result = begin(COMMAND_DIRECTION, mask, _direction);
+
+    if (result)
+    {
+        doneCallback = callback;
+    }
+
+    return result;
+}
+
+bool GPIOExpanderSimulator::bulkWrite(uint32_t mask, uint32_t values, FunctionPointer0<void> callback)
+{
+    bool result = begin(COMMAND_WRITE, mask, values);
+
+    if (result)
+    {
+        doneCallback = callback;
+    }
+
+    return result;
+}
+
+bool GPIOExpanderSimulator::bulkRead(FunctionPointer1<void, uint32_t> callback)
+{
+    bool result = begin(COMMAND_READ, 0, 0);
+
+    if (result)
+    {
+        readCallback = callback;
+    }
+
+    return result;
+}
+
+bool GPIOExpanderSimulator::bulkSetInterrupt(uint32_t mask, uint32_t enable, FunctionPointer0<void> callback)
+{
+    bool result = begin(COMMAND_INTERRUPT, mask, enable);
+
+    if (result)
+    {
+        doneCallback = callback;
+    }
+
+    return result;
+}
+
+void GPIOExpanderSimulator::setInterruptHandler(FunctionPointer3<void, uint16_t, uint32_t, uint32_t> handler)
+{
+    interruptHandler = handler;
+}
+
+void GPIOExpanderSimulator::setLatency(uint32_t milliseconds)
+{
+    latency = milliseconds;
+}
+
+void GPIOExpanderSimulator::setBusyInterval(uint32_t interval)
+{
+    busyInterval = interval;
+}
+
+void GPIOExpanderSimulator::setNackInterval(uint32_t interval)
+{
+    nackInterval = interval;
+}
+
+void GPIOExpanderSimulator::setInput(uint32_t mask, uint32_t values)
+{
+    uint32_t before = getPins();
+
+    inputs = (inputs & ~mask) | (values & mask);
+
+    // only interrupt enabled inputs generate interrupts
+    uint32_t changed = (before ^ getPins()) & interruptMask & ~direction;
+
+    // without an interrupt pin, changes are only seen by reading
+    if (changed && interruptHandler && (irq != NC))
+    {
+        // coalesce changes until the interrupt has been serviced
+        if (interruptPins == 0)
+        {
+            FunctionPointer0<void> fp(this, &GPIOExpanderSimulator::interrupt);
+            minar::Scheduler::postCallback(fp)
+                .delay(minar::milliseconds(latency))
+                .tolerance(0);
+        }
+
+        interruptPins |= changed;
+    }
+}
+
+uint32_t GPIOExpanderSimulator::getPins(void) const
+{
+    return (outputs & direction) | (inputs & ~direction);
+}
+
+uint32_t GPIOExpanderSimulator::getDirection(void) const
+{
+    return direction;
+}
+
+uint32_t GPIOExpanderSimulator::getInterruptMask(void) const
+{
+    return interruptMask;
+}
+
+uint32_t GPIOExpanderSimulator::getCommandCount(void) const
+{
+    return commandCount;
+}
+
+bool GPIOExpanderSimulator::begin(command_t _command, uint32_t mask, uint32_t value)
+{
+    bool result = false;
+
+    requestCount++;
+
+    // only one command at a time, like the bus
+    if ((command == COMMAND_NONE) &&
+        ((busyInterval == 0) || (requestCount % busyInterval)))
+    {
+        command = _command;
+        commandMask = mask;
+        commandValue = value;
+        commandCount++;
+
+        FunctionPointer0<void> fp(this, &GPIOExpanderSimulator::complete);
+        minar::Scheduler::postCallback(fp)
+            .delay(minar::milliseconds(latency))
+            .tolerance(0);
+
+        result = true;
+    }
+
+    return result;
+}
+
+void GPIOExpanderSimulator::complete(void)
+{
+    bool nack = (nackInterval > 0) && ((commandCount % nackInterval) == 0);
+    uint32_t values = 0;
+
+    if (nack == false)
+    {
+        switch (command)
+        {
+            case COMMAND_DIRECTION:
+                direction = (direction & ~commandMask) | (commandValue & commandMask);
+                break;
+
+            case COMMAND_WRITE:
+                outputs = (outputs & ~commandMask) | (commandValue & commandMask);
+                break;
+
+            case COMMAND_READ:
+                values = getPins();
+                break;
+
+            case COMMAND_INTERRUPT:
+                interruptMask = (interruptMask & ~commandMask) | (commandValue & commandMask);
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    command_t done = command;
+    command = COMMAND_NONE;
+
+    // the callback may issue the next command
+    if (done == COMMAND_READ)
+    {
+        if (readCallback)
+        {
+            readCallback.call(values);
+        }
+    }
+    else if (doneCallback)
+    {
+        doneCallback.call();
+    }
+}
+
+void GPIOExpanderSimulator::interrupt(void)
+{
+    uint32_t pins = interruptPins;
+    interruptPins = 0;
+
+    interruptHandler.call(address, pins, getPins());
+}
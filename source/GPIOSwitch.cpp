@@ -16,11 +16,16 @@
  */
 
 #include "wrd-gpio-switch/GPIOSwitch.h"
-#include "wrd-gpio-expander/GPIOExpander.h"
+#include "GPIOSwitchPlatform.h"
+
+#include <new>
 
-#include "core-util/SharedPointer.h"
-#include <queue>
-#include <map>
+#if YOTTA_CFG_WRD_GPIO_SWITCH_SIMULATOR
+#include "wrd-gpio-switch/GPIOExpanderSimulator.h"
+typedef GPIOExpanderSimulator GPIOExpander;
+#else
+#include "wrd-gpio-expander/GPIOExpander.h"
+#endif
 
 using namespace mbed::util;
 
@@ -30,30 +35,156 @@ namespace GPIOSwitch
 
 #define LOCATION_SIZE YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_SIZE
 
-#if (LOCATION_SIZE == 1)
-static uint32_t locationValues[1] = { 0 };
-static uint16_t locationAddress[1] = { YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_GPIO0_I2C_ADDRESS };
+#if YOTTA_CFG_WRD_GPIO_SWITCH_QUEUE_SIZE
+#define QUEUE_SIZE YOTTA_CFG_WRD_GPIO_SWITCH_QUEUE_SIZE
+#else
+#define QUEUE_SIZE 16
+#endif
 
-static GPIOExpander gpio[1] = { { YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_GPIO0_I2C_SDA,
-                                  YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_GPIO0_I2C_SCL,
-                                  YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_GPIO0_I2C_ADDRESS,
-                                  YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_GPIO0_IRQ_PIN} };
+#if (QUEUE_SIZE > 255)
+#error wrd-gpio-switch queue-size must be less than 256
+#endif
 
-#elif (LOCATION_SIZE == 2)
-static uint32_t locationValues[2] = { 0, 0 };
-static uint16_t locationAddress[2] = { YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_GPIO0_I2C_ADDRESS,
-                                       YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_GPIO1_I2C_ADDRESS };
+#if YOTTA_CFG_WRD_GPIO_SWITCH_HIGH_PRIORITY_QUEUE_SIZE
+#define HIGH_QUEUE_SIZE YOTTA_CFG_WRD_GPIO_SWITCH_HIGH_PRIORITY_QUEUE_SIZE
+#else
+#define HIGH_QUEUE_SIZE 4
+#endif
+
+#if (HIGH_QUEUE_SIZE < 1) || (HIGH_QUEUE_SIZE > 255)
+#error wrd-gpio-switch high-priority-queue-size must be between 1 and 255
+#endif
+
+/* number of high priority commands served in a row before a pending
+   normal priority command gets its turn.
+*/
+#if YOTTA_CFG_WRD_GPIO_SWITCH_PRIORITY_BURST
+#define PRIORITY_BURST YOTTA_CFG_WRD_GPIO_SWITCH_PRIORITY_BURST
+#else
+#define PRIORITY_BURST 4
+#endif
+
+#if (PRIORITY_BURST < 1) || (PRIORITY_BURST > 255)
+#error wrd-gpio-switch priority-burst must be between 1 and 255
+#endif
+
+#if YOTTA_CFG_WRD_GPIO_SWITCH_IRQ_QUEUE_SIZE
+#define IRQ_QUEUE_SIZE YOTTA_CFG_WRD_GPIO_SWITCH_IRQ_QUEUE_SIZE
+#else
+#define IRQ_QUEUE_SIZE 16
+#endif
+
+#if (IRQ_QUEUE_SIZE > 128) || (IRQ_QUEUE_SIZE & (IRQ_QUEUE_SIZE - 1))
+#error wrd-gpio-switch irq-queue-size must be a power of 2 no larger than 128
+#endif
+
+#if YOTTA_CFG_WRD_GPIO_SWITCH_RETRY_DELAY_MIN
+#define RETRY_DELAY_MIN YOTTA_CFG_WRD_GPIO_SWITCH_RETRY_DELAY_MIN
+#else
+#define RETRY_DELAY_MIN 1
+#endif
+
+#if YOTTA_CFG_WRD_GPIO_SWITCH_RETRY_DELAY_MAX
+#define RETRY_DELAY_MAX YOTTA_CFG_WRD_GPIO_SWITCH_RETRY_DELAY_MAX
+#else
+#define RETRY_DELAY_MAX 64
+#endif
+
+#if (RETRY_DELAY_MIN < 1) || (RETRY_DELAY_MAX < RETRY_DELAY_MIN) || (RETRY_DELAY_MAX > 65535)
+#error wrd-gpio-switch retry delays must satisfy 1 <= retry-delay-min <= retry-delay-max < 65536
+#endif
 
-static GPIOExpander gpio[2] = { { YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_GPIO0_I2C_SDA,
-                                  YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_GPIO0_I2C_SCL,
-                                  YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_GPIO0_I2C_ADDRESS,
-                                  YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_GPIO0_IRQ_PIN},
-                                { YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_GPIO1_I2C_SDA,
-                                  YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_GPIO1_I2C_SCL,
-                                  YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_GPIO1_I2C_ADDRESS,
-                                  YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_GPIO1_IRQ_PIN} };
+/* period in milliseconds for scanning expanders without an interrupt pin */
+#if YOTTA_CFG_WRD_GPIO_SWITCH_SCAN_PERIOD
+#define SCAN_PERIOD YOTTA_CFG_WRD_GPIO_SWITCH_SCAN_PERIOD
+#else
+#define SCAN_PERIOD 50
+#endif
+
+/* number of pins that can be debounced at the same time */
+#if YOTTA_CFG_WRD_GPIO_SWITCH_DEBOUNCE_SLOTS
+#define DEBOUNCE_SLOTS YOTTA_CFG_WRD_GPIO_SWITCH_DEBOUNCE_SLOTS
+#else
+#define DEBOUNCE_SLOTS 8
+#endif
+
+/* samples needed to change state in integrator mode */
+#define DEBOUNCE_STEPS 4
+
+#if (LOCATION_SIZE < 1) || (LOCATION_SIZE > 8)
+#error wrd-gpio-expander size must be between 1 and 8
+#endif
+
+/* Expander n is described by the GPIO<n> entries in the yotta config. */
+#define GPIO_ADDRESS(n)  YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_GPIO ## n ## _I2C_ADDRESS
+#define GPIO_EXPANDER(n) { YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_GPIO ## n ## _I2C_SDA, \
+                           YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_GPIO ## n ## _I2C_SCL, \
+                           YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_GPIO ## n ## _I2C_ADDRESS, \
+                           YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_GPIO ## n ## _IRQ_PIN }
+
+#define GPIO_HAS_IRQ(n)  (YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_GPIO ## n ## _IRQ_PIN != NC)
+
+/* Expand macro for every configured expander. */
+#if (LOCATION_SIZE == 1)
+#define FOR_EACH_LOCATION(X) X(0)
+#elif (LOCATION_SIZE == 2)
+#define FOR_EACH_LOCATION(X) X(0), X(1)
+#elif (LOCATION_SIZE == 3)
+#define FOR_EACH_LOCATION(X) X(0), X(1), X(2)
+#elif (LOCATION_SIZE == 4)
+#define FOR_EACH_LOCATION(X) X(0), X(1), X(2), X(3)
+#elif (LOCATION_SIZE == 5)
+#define FOR_EACH_LOCATION(X) X(0), X(1), X(2), X(3), X(4)
+#elif (LOCATION_SIZE == 6)
+#define FOR_EACH_LOCATION(X) X(0), X(1), X(2), X(3), X(4), X(5)
+#elif (LOCATION_SIZE == 7)
+#define FOR_EACH_LOCATION(X) X(0), X(1), X(2), X(3), X(4), X(5), X(6)
+#elif (LOCATION_SIZE == 8)
+#define FOR_EACH_LOCATION(X) X(0), X(1), X(2), X(3), X(4), X(5), X(6), X(7)
 #endif
 
+static uint32_t locationValues[LOCATION_SIZE] = { 0 };
+static constexpr uint16_t locationAddress[LOCATION_SIZE] = { FOR_EACH_LOCATION(GPIO_ADDRESS) };
+static constexpr bool locationHasIrq[LOCATION_SIZE] = { FOR_EACH_LOCATION(GPIO_HAS_IRQ) };
+
+/* Input shadow registers. inputValues holds the pin values from the last
+   read, updated with changed pins from interrupts. inputTime is when the
+   last read completed and inputValid is false until the first read.
+   trackedPins are kept up to date by interrupts, see trackInput, and are
+   set in trackedValid once the read that seeds them has completed.
+*/
+static uint32_t inputValues[LOCATION_SIZE] = { 0 };
+static minar::tick_t inputTime[LOCATION_SIZE] = { 0 };
+static bool inputValid[LOCATION_SIZE] = { false };
+static uint32_t trackedPins[LOCATION_SIZE] = { 0 };
+static uint32_t trackedValid[LOCATION_SIZE] = { 0 };
+
+static GPIOExpander gpio[LOCATION_SIZE] = { FOR_EACH_LOCATION(GPIO_EXPANDER) };
+
+    /* Index into gpio[] plus one for the expander at address, 0 if none. */
+    static constexpr uint8_t findLocation(uint16_t address, uint8_t index = 0)
+    {
+        return (index >= LOCATION_SIZE) ? 0 :
+               (locationAddress[index] == address) ? index + 1 :
+               findLocation(address, index + 1);
+    }
+
+/* Address to index table covering all 8-bit I2C addresses. The table is
+   computed at compile time and placed in flash.
+*/
+#define ADDRESS_1(a)  findLocation(a)
+#define ADDRESS_4(a)  ADDRESS_1(a), ADDRESS_1(a + 1), ADDRESS_1(a + 2), ADDRESS_1(a + 3)
+#define ADDRESS_16(a) ADDRESS_4(a), ADDRESS_4(a + 4), ADDRESS_4(a + 8), ADDRESS_4(a + 12)
+#define ADDRESS_64(a) ADDRESS_16(a), ADDRESS_16(a + 16), ADDRESS_16(a + 32), ADDRESS_16(a + 48)
+
+static const uint8_t addressTable[256] = { ADDRESS_64(0), ADDRESS_64(64), ADDRESS_64(128), ADDRESS_64(192) };
+
+    /* Index into gpio[] for location, -1 if location is not an I/O expander. */
+    static inline int lookupIndex(uint16_t location)
+    {
+        return (location < 256) ? (int) addressTable[location] - 1 : -1;
+    }
+
     typedef enum {
         ACTION_READ,
         ACTION_WRITE,
@@ -62,239 +193,1735 @@ static GPIOExpander gpio[2] = { { YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_GPIO0_I2C
         ACTION_NONE
     } action_t;
 
+    /* Transactions operate on a mask of pins. Single pin operations use
+       a mask with only that pin set. Each transaction has at most one
+       callback, so the callback types share storage and callbackType
+       selects the one in use.
+    */
     class Transaction
     {
     public:
-        Transaction(uint8_t _pin,
-                    uint8_t _index,
-                    FunctionPointer1<void, int>& _callback)
-            :   action(ACTION_READ),
-                pin(_pin),
-                index(_index),
-                read(_callback)
+        typedef FunctionPointer1<void, int> read_t;
+        typedef FunctionPointer1<void, uint32_t> read_port_t;
+        typedef FunctionPointer0<void> write_t;
+
+        Transaction()
+            :   action(ACTION_NONE),
+                mask(0),
+                value(0),
+                callbackType(CALLBACK_NONE)
         { }
 
         Transaction(uint8_t _pin,
-                    uint8_t _index,
-                    int8_t _parameter,
-                    FunctionPointer0<void> _callback)
+                    read_t& _callback)
+            :   action(ACTION_READ),
+                mask((uint32_t)1 << _pin),
+                value(0),
+                callbackType(CALLBACK_NONE)
+        {
+            if (_callback)
+            {
+                new (&read) read_t(_callback);
+                callbackType = CALLBACK_READ;
+            }
+        }
+
+        Transaction(uint32_t _mask,
+                    read_port_t& _callback)
+            :   action(ACTION_READ),
+                mask(_mask),
+                value(0),
+                callbackType(CALLBACK_NONE)
+        {
+            if (_callback)
+            {
+                new (&readPort) read_port_t(_callback);
+                callbackType = CALLBACK_READ_PORT;
+            }
+        }
+
+        Transaction(uint32_t _mask,
+                    uint32_t _value,
+                    write_t _callback)
             :   action(ACTION_WRITE),
-                pin(_pin),
-                index(_index),
-                parameter(_parameter),
-                write(_callback)
-        { }
+                mask(_mask),
+                value(_value & _mask),
+                callbackType(CALLBACK_NONE)
+        {
+            if (_callback)
+            {
+                new (&write) write_t(_callback);
+                callbackType = CALLBACK_WRITE;
+            }
+        }
 
         Transaction(action_t _action,
-                    uint8_t _pin,
-                    uint8_t _index,
-                    int8_t _parameter)
+                    uint32_t _mask,
+                    uint32_t _value)
             :   action(_action),
-                pin(_pin),
-                index(_index),
-                parameter(_parameter)
+                mask(_mask),
+                value(_value & _mask),
+                callbackType(CALLBACK_NONE)
         { }
 
+        Transaction(const Transaction& other)
+            :   action(other.action),
+                mask(other.mask),
+                value(other.value),
+                callbackType(CALLBACK_NONE)
+        {
+            setCallback(other);
+        }
+
+        ~Transaction()
+        {
+            clearCallback();
+        }
+
+        Transaction& operator=(const Transaction& other)
+        {
+            if (this != &other)
+            {
+                action = other.action;
+                mask = other.mask;
+                value = other.value;
+
+                setCallback(other);
+            }
+
+            return *this;
+        }
+
+        bool hasCallback(void) const
+        {
+            return (callbackType != CALLBACK_NONE);
+        }
+
+        /* Replace the callback with the one from other. */
+        void setCallback(const Transaction& other)
+        {
+            clearCallback();
+
+            switch (other.callbackType)
+            {
+                case CALLBACK_READ:
+                    new (&read) read_t(other.read);
+                    break;
+
+                case CALLBACK_READ_PORT:
+                    new (&readPort) read_port_t(other.readPort);
+                    break;
+
+                case CALLBACK_WRITE:
+                    new (&write) write_t(other.write);
+                    break;
+
+                default:
+                    break;
+            }
+
+            callbackType = other.callbackType;
+        }
+
+        /* Post the callback once the command has completed. For reads,
+           values holds all pins of the location.
+        */
+        void complete(uint32_t values)
+        {
+            switch (callbackType)
+            {
+                case CALLBACK_READ:
+                    minar::Scheduler::postCallback(read.bind((values & mask) ? 1 : 0))
+                        .tolerance(1);
+                    break;
+
+                case CALLBACK_READ_PORT:
+                    minar::Scheduler::postCallback(readPort.bind(values & mask))
+                        .tolerance(1);
+                    break;
+
+                case CALLBACK_WRITE:
+                    minar::Scheduler::postCallback(write)
+                        .tolerance(1);
+                    break;
+
+                default:
+                    break;
+            }
+        }
+
         action_t action;
+        uint32_t mask;
+        uint32_t value;
+
+    private:
+        typedef enum {
+            CALLBACK_NONE,
+            CALLBACK_READ,
+            CALLBACK_READ_PORT,
+            CALLBACK_WRITE
+        } callback_t;
+
+        void clearCallback(void)
+        {
+            switch (callbackType)
+            {
+                case CALLBACK_READ:
+                    read.~read_t();
+                    break;
+
+                case CALLBACK_READ_PORT:
+                    readPort.~read_port_t();
+                    break;
+
+                case CALLBACK_WRITE:
+                    write.~write_t();
+                    break;
+
+                default:
+                    break;
+            }
+
+            callbackType = CALLBACK_NONE;
+        }
+
+        callback_t callbackType;
+
+        union
+        {
+            read_t read;
+            read_port_t readPort;
+            write_t write;
+        };
+    };
+
+    /* Fixed size FIFO of transactions. Slots are provided by the owner and
+       reused in place so queueing a transaction never allocates memory.
+    */
+    class TransactionQueue
+    {
+    public:
+        TransactionQueue(Transaction* _slots, uint8_t _capacity)
+            :   slots(_slots),
+                capacity(_capacity),
+                head(0),
+                count(0)
+        { }
+
+        bool push(const Transaction& transaction)
+        {
+            bool result = false;
+
+            if (count < capacity)
+            {
+                slots[(head + count) % capacity] = transaction;
+                count++;
+
+                result = true;
+            }
+
+            return result;
+        }
+
+        void pop(void)
+        {
+            head = (head + 1) % capacity;
+            count--;
+        }
+
+        Transaction& front(void)
+        {
+            return slots[head];
+        }
+
+        Transaction& operator[](uint8_t position)
+        {
+            return slots[(head + position) % capacity];
+        }
+
+        uint8_t size(void) const
+        {
+            return count;
+        }
+
+    private:
+        Transaction* slots;
+        uint8_t capacity;
+        uint8_t head;
+        uint8_t count;
+    };
+
+    /* Each I/O expander has its own queues and is processed independently,
+       so a slow transaction on one expander does not block the others.
+       High priority transactions are served before normal priority ones,
+       but at most PRIORITY_BURST in a row while normal work is waiting.
+    */
+    class LocationQueue
+    {
+    public:
+        LocationQueue()
+            :   normalQueue(normalSlots, QUEUE_SIZE),
+                highQueue(highSlots, HIGH_QUEUE_SIZE),
+                inflightQueue(&normalQueue),
+                running(false),
+                inflightCount(0),
+                highBurst(0),
+                retryDelay(RETRY_DELAY_MIN),
+                retryHandle(NULL),
+                configPosted(false)
+        {
+            for (uint8_t idx = 0; idx < CONFIG_SIZE; idx++)
+            {
+                configMask[idx] = 0;
+                configValue[idx] = 0;
+                deviceValue[idx] = 0;
+                deviceKnown[idx] = 0;
+            }
+        }
+
+        bool enqueue(const Transaction& transaction,
+                     priority_t priority = PRIORITY_NORMAL);
+        void configure(action_t action, uint32_t mask, uint32_t value);
+        bool resynchronize(void);
+
+    private:
+        bool push(const Transaction& transaction, priority_t priority);
+        void flushConfig(void);
+        bool mergeWrite(TransactionQueue& queue, const Transaction& transaction);
+        uint32_t unsentWrites(TransactionQueue& queue);
+        void supersedeWrites(TransactionQueue& queue, uint32_t mask);
+        TransactionQueue& selectQueue(void);
+        void process(void);
+        void retry(void);
+        void wakeup(void);
+        void processLander(void);
+        void processDone(uint32_t values);
+
+        uint8_t index(void) const;
+
+        Transaction normalSlots[QUEUE_SIZE];
+        Transaction highSlots[HIGH_QUEUE_SIZE];
+        TransactionQueue normalQueue;
+        TransactionQueue highQueue;
+
+        /* queue the command currently being processed was taken from */
+        TransactionQueue* inflightQueue;
+
+        /* true from when process has been scheduled until the queues are empty */
+        bool running;
+
+        /* number of transactions at the front of inflightQueue covered by
+           the command currently being processed by the I/O expander.
+        */
+        uint8_t inflightCount;
+
+        /* high priority commands served since the last normal one */
+        uint8_t highBurst;
+
+        /* delay in milliseconds before the next attempt when the I/O
+           expander is busy. Doubles on every busy result up to
+           RETRY_DELAY_MAX and is reset when a command is accepted.
+        */
+        uint16_t retryDelay;
+
+        /* handle for the pending retry, NULL when no retry is scheduled */
+        minar::callback_handle_t retryHandle;
+
+        /* Configuration collected by configure, indexed by action starting
+           from ACTION_WRITE. Sent as one transaction per action by
+           flushConfig, in the order write, direction, interrupt, so
+           outputs have their initial value before they are enabled.
+        */
+        static const uint8_t CONFIG_SIZE = ACTION_INTERRUPT - ACTION_WRITE + 1;
+        uint32_t configMask[CONFIG_SIZE];
+        uint32_t configValue[CONFIG_SIZE];
+        bool configPosted;
+
+        /* Output, direction and interrupt enable state of the device once
+           all queued commands have been sent, indexed like configMask.
+           Updated when a command is queued. Only bits set in deviceKnown
+           are valid, the rest have never been sent.
+        */
+        uint32_t deviceValue[CONFIG_SIZE];
+        uint32_t deviceKnown[CONFIG_SIZE];
+    };
+
+    /* Queues are constructed on first use, because the public API can be
+       called from constructors of other static objects.
+    */
+    static LocationQueue& getQueue(uint8_t index)
+    {
+        static LocationQueue queues[LOCATION_SIZE];
+
+        return queues[index];
+    }
+
+    /*************************************************************************/
+
+    /* Writes from interrupt context are placed in a single producer, single
+       consumer ring. The producer (writeOutputIrq) only advances the tail
+       and the consumer (processIrqQueue) only advances the head, so neither
+       side needs a lock. Indices are free running and wrap at 256.
+    */
+    typedef struct {
         uint8_t pin;
         uint8_t index;
-        int8_t parameter;
+        int8_t value;
+    } irqWrite_t;
+
+    static void processIrqQueue(void);
+    static void drainIrqQueue(void);
+    static irqWrite_t irqQueue[IRQ_QUEUE_SIZE];
+    static volatile uint8_t irqQueueHead = 0;
+    static volatile uint8_t irqQueueTail = 0;
+
+    /* set by the producer when processIrqQueue has been posted, so at most
+       one MINAR callback is outstanding regardless of the interrupt rate.
+    */
+    static volatile bool irqQueuePosted = false;
+
+    /*************************************************************************/
+
+#if YOTTA_CFG_WRD_GPIO_SWITCH_STATISTICS
+    static statistics_t statistics[LOCATION_SIZE];
+    static minar::tick_t inflightStart[LOCATION_SIZE];
+
+#define STATISTICS_ADD(index, field, value) statistics[index].field += (value)
+#define STATISTICS_DEPTH(index, depth)                                  \
+    do {                                                                \
+        statistics[index].queueDepth = (depth);                         \
+        if (statistics[index].queueDepthMax < (depth))                  \
+        {                                                               \
+            statistics[index].queueDepthMax = (depth);                  \
+        }                                                               \
+    } while (0)
+#define STATISTICS_START(index) inflightStart[index] = minar::Scheduler::getTime()
+#define STATISTICS_STOP(index)                                          \
+    statistics[index].timeInFlight += minar::Scheduler::getTime() - inflightStart[index]
+#else
+#define STATISTICS_ADD(index, field, value)
+#define STATISTICS_DEPTH(index, depth)
+#define STATISTICS_START(index)
+#define STATISTICS_STOP(index)
+#endif
+
+    /*************************************************************************/
+
+    /* interrupt callbacks indexed by location index and pin */
+    static FunctionPointer1<void, int> interruptTable[LOCATION_SIZE][32];
+
+    /* port interrupt callback and its pins for each location, see
+       processBatch.
+    */
+    static FunctionPointer3<void, uint16_t, uint32_t, uint32_t> portInterruptTable[LOCATION_SIZE];
+    static uint32_t portInterruptPins[LOCATION_SIZE] = { 0 };
+
+    /*************************************************************************/
+
+    uint8_t LocationQueue::index(void) const
+    {
+        return this - &getQueue(0);
+    }
+
+    /* Merge a write into the newest pending transaction if it is also a
+       write. Values in the new write supersede the pending ones, so repeated
+       writes to the same pins only occupy one slot and one bus transaction.
+       Transactions currently being processed are never modified.
+    */
+    bool LocationQueue::mergeWrite(TransactionQueue& queue, const Transaction& transaction)
+    {
+        bool result = false;
+        uint8_t inflight = (&queue == inflightQueue) ? inflightCount : 0;
+
+        if (queue.size() > inflight)
+        {
+            Transaction& pending = queue[queue.size() - 1];
+
+            /* each transaction holds a single callback */
+            if ((pending.action == ACTION_WRITE) &&
+                !(pending.hasCallback() && transaction.hasCallback()))
+            {
+                pending.mask |= transaction.mask;
+                pending.value = (pending.value & ~transaction.mask) | transaction.value;
+
+                if (transaction.hasCallback())
+                {
+                    pending.setCallback(transaction);
+                }
+
+                result = true;
+            }
+        }
+
+        return result;
+    }
+
+    /* Remove pins from writes that are queued but not yet sent. A write
+       queued at the other priority can be sent before older writes to the
+       same pins, which would then overwrite it with a stale value. Emptied
+       writes stay queued so their callbacks are called in order.
+    */
+    void LocationQueue::supersedeWrites(TransactionQueue& queue, uint32_t mask)
+    {
+        uint8_t inflight = (&queue == inflightQueue) ? inflightCount : 0;
+
+        for (uint8_t position = inflight; position < queue.size(); position++)
+        {
+            Transaction& pending = queue[position];
+
+            if (pending.action == ACTION_WRITE)
+            {
+                pending.mask &= ~mask;
+                pending.value &= ~mask;
+            }
+        }
+    }
+
+    /* Pins written by writes that are queued but not yet sent. */
+    uint32_t LocationQueue::unsentWrites(TransactionQueue& queue)
+    {
+        uint32_t mask = 0;
+        uint8_t inflight = (&queue == inflightQueue) ? inflightCount : 0;
+
+        for (uint8_t position = inflight; position < queue.size(); position++)
+        {
+            if (queue[position].action == ACTION_WRITE)
+            {
+                mask |= queue[position].mask;
+            }
+        }
+
+        return mask;
+    }
+
+    /* Add transaction to queue after any pending configuration, so commands
+       are still sent in the order they were issued.
+    */
+    bool LocationQueue::enqueue(const Transaction& transaction, priority_t priority)
+    {
+        flushConfig();
+
+        return push(transaction, priority);
+    }
+
+    /* Collect configuration for pins. Later values for the same pin replace
+       earlier ones. Everything collected before MINAR runs the flush, e.g.
+       from constructors of static objects, is sent with at most one
+       transaction per action.
+    */
+    void LocationQueue::configure(action_t action, uint32_t mask, uint32_t value)
+    {
+        uint8_t idx = action - ACTION_WRITE;
+
+        configMask[idx] |= mask;
+        configValue[idx] = (configValue[idx] & ~mask) | (value & mask);
+
+        if (configPosted == false)
+        {
+            configPosted = true;
+
+            FunctionPointer0<void> fp(this, &LocationQueue::flushConfig);
+            minar::Scheduler::postCallback(fp)
+                .tolerance(1);
+        }
+    }
+
+    void LocationQueue::flushConfig(void)
+    {
+        configPosted = false;
+
+        for (uint8_t idx = 0; idx < CONFIG_SIZE; idx++)
+        {
+            if (configMask[idx])
+            {
+                action_t action = (action_t) (ACTION_WRITE + idx);
+
+                Transaction transaction(action, configMask[idx], configValue[idx]);
+
+                // keep configuration for the next flush if queue is full
+                if (push(transaction, PRIORITY_NORMAL))
+                {
+                    configMask[idx] = 0;
+                    configValue[idx] = 0;
+                }
+            }
+        }
+    }
+
+    /* Send the known device state again, e.g. after the I/O expander has
+       been reset. Nothing is elided until the state has been sent.
+    */
+    bool LocationQueue::resynchronize(void)
+    {
+        bool result = true;
+
+        flushConfig();
+
+        for (uint8_t idx = 0; idx < CONFIG_SIZE; idx++)
+        {
+            uint32_t mask = deviceKnown[idx];
+
+            if (mask)
+            {
+                action_t action = (action_t) (ACTION_WRITE + idx);
+
+                deviceKnown[idx] = 0;
+
+                result = push(Transaction(action, mask, deviceValue[idx]), PRIORITY_NORMAL) && result;
+            }
+        }
+
+        return result;
+    }
+
+    /* Add transaction to queue and schedule processing if the queue is idle.
+       Writes, direction and interrupt changes only carry the pins that
+       differ from the device state. A command that changes nothing is not
+       sent, but its callback is still called. If other commands are queued,
+       the callback is queued as an empty write so it keeps its place.
+    */
+    bool LocationQueue::push(const Transaction& transaction, priority_t priority)
+    {
+        bool result = false;
+        bool queued = false;
+        TransactionQueue& queue = (priority == PRIORITY_HIGH) ? highQueue : normalQueue;
+
+        bool shadowed = (transaction.action >= ACTION_WRITE) &&
+                        (transaction.action <= ACTION_INTERRUPT);
+        uint8_t idx = (shadowed) ? transaction.action - ACTION_WRITE : 0;
+
+        Transaction changed = transaction;
+
+        /* pins with unsent writes in the other queue are sent by this
+           write, even if the value matches, so its callback is not called
+           before the pins have been set.
+        */
+        TransactionQueue& other = (&queue == &highQueue) ? normalQueue : highQueue;
+        uint32_t superseded = (transaction.action == ACTION_WRITE) ?
+                              unsentWrites(other) & transaction.mask : 0;
+
+        if (shadowed)
+        {
+            changed.mask &= ~deviceKnown[idx] | (deviceValue[idx] ^ transaction.value) | superseded;
+            changed.value &= changed.mask;
+        }
+
+        if (changed.action == ACTION_WRITE)
+        {
+            result = mergeWrite(queue, changed);
+        }
+
+        if (result == false)
+        {
+            bool idle = (normalQueue.size() == 0) && (highQueue.size() == 0);
+
+            if (shadowed && (changed.mask == 0) && (idle || (changed.hasCallback() == false)))
+            {
+                // no-op without a callback or with nothing queued ahead
+                changed.complete(0);
+
+                result = true;
+            }
+            else
+            {
+                result = queue.push(changed);
+                queued = result;
+            }
+        }
+
+        if (result && superseded)
+        {
+            supersedeWrites(other, superseded);
+        }
+
+        if (result && shadowed)
+        {
+            deviceValue[idx] = (deviceValue[idx] & ~changed.mask) | changed.value;
+            deviceKnown[idx] |= changed.mask;
+        }
+
+        STATISTICS_DEPTH(index(), normalQueue.size() + highQueue.size());
+
+        if (queued && (running == false))
+        {
+            running = true;
+
+            FunctionPointer0<void> fp(this, &LocationQueue::process);
+            minar::Scheduler::postCallback(fp)
+                .tolerance(1);
+        }
+
+        return result;
+    }
+
+    void LocationQueue::processLander(void)
+    {
+        processDone(0);
+    }
+
+    void LocationQueue::processDone(uint32_t values)
+    {
+        TransactionQueue& sendQueue = *inflightQueue;
+
+        /* every read returns all pins, refresh the input shadow */
+        if (sendQueue.front().action == ACTION_READ)
+        {
+            inputValues[index()] = values;
+            inputTime[index()] = minar::Scheduler::getTime();
+            inputValid[index()] = true;
+        }
+
+        /* pop all transactions covered by the completed command */
+        for ( ; inflightCount > 0; inflightCount--)
+        {
+            Transaction& transaction = sendQueue.front();
+
+            if (transaction.action == ACTION_READ)
+            {
+                // pins seeded by this read, see trackInput
+                trackedValid[index()] |= transaction.value & trackedPins[index()];
+            }
+
+            transaction.complete(values);
+
+            sendQueue.pop();
+        }
+
+        STATISTICS_STOP(index());
+        STATISTICS_DEPTH(index(), normalQueue.size() + highQueue.size());
+
+        /* move interrupt writes and configuration that did not fit in the
+           queue earlier.
+        */
+        drainIrqQueue();
+        flushConfig();
+
+        /* this location keeps the bus while it has work, because process
+           below claims it before a woken location could run. Once the
+           queues are empty the bus is free, so locations waiting in
+           backoff can try again right away.
+        */
+        if ((normalQueue.size() == 0) && (highQueue.size() == 0))
+        {
+            for (uint8_t idx = 0; idx < LOCATION_SIZE; idx++)
+            {
+                if (idx != index())
+                {
+                    getQueue(idx).wakeup();
+                }
+            }
+        }
+
+        /* continue directly with the next transaction instead of
+           going through the scheduler again.
+        */
+        process();
+    }
+
+    void LocationQueue::retry(void)
+    {
+        retryHandle = NULL;
+
+        process();
+    }
+
+    void LocationQueue::wakeup(void)
+    {
+        if (retryHandle)
+        {
+            minar::Scheduler::cancelCallback(retryHandle);
+            retryHandle = NULL;
+
+            FunctionPointer0<void> fp(this, &LocationQueue::retry);
+            minar::Scheduler::postCallback(fp)
+                .tolerance(1);
+        }
+    }
+
+    /* Pick the queue to serve next. High priority work goes first unless
+       it has had PRIORITY_BURST turns in a row while normal work waited.
+    */
+    TransactionQueue& LocationQueue::selectQueue(void)
+    {
+        bool useHigh = (highQueue.size() > 0) &&
+                       ((normalQueue.size() == 0) || (highBurst < PRIORITY_BURST));
+
+        if (useHigh)
+        {
+            highBurst++;
+        }
+        else
+        {
+            highBurst = 0;
+        }
+
+        return (useHigh) ? highQueue : normalQueue;
+    }
+
+    void LocationQueue::process(void)
+    {
+        // only process if a queue is not empty
+        if ((normalQueue.size() > 0) || (highQueue.size() > 0))
+        {
+            bool result = false;
+
+            /* a command rejected as busy is selected again on retry, so the
+               burst counter only advances for accepted commands.
+            */
+            uint8_t previousBurst = highBurst;
+            TransactionQueue& sendQueue = selectQueue();
+            inflightQueue = &sendQueue;
+
+            /* get next transaction */
+            Transaction& transaction = sendQueue.front();
+            inflightCount = 1;
+
+            FunctionPointer0<void> lander(this, &LocationQueue::processLander);
+
+            switch(transaction.action)
+            {
+                case ACTION_READ:
+                    {
+                        /* Serve all consecutive reads with a single bulkRead. */
+                        inflightCount = 0;
+
+                        while ((inflightCount < sendQueue.size()) &&
+                               (sendQueue[inflightCount].action == ACTION_READ))
+                        {
+                            inflightCount++;
+                        }
+
+                        FunctionPointer1<void, uint32_t> done(this, &LocationQueue::processDone);
+                        result = gpio[index()].bulkRead(done);
+
+                        STATISTICS_ADD(index(), reads, (result) ? 1 : 0);
+                    }
+                    break;
+
+                case ACTION_WRITE:
+                    {
+                        /* Coalesce consecutive writes into a single masked
+                           bulkWrite. Later writes to the same pin take
+                           precedence over earlier ones.
+                        */
+                        uint32_t mask = 0;
+                        uint32_t value = 0;
+                        inflightCount = 0;
+
+                        while ((inflightCount < sendQueue.size()) &&
+                               (sendQueue[inflightCount].action == ACTION_WRITE))
+                        {
+                            Transaction& next = sendQueue[inflightCount];
+
+                            mask |= next.mask;
+                            value = (value & ~next.mask) | next.value;
+
+                            inflightCount++;
+                        }
+
+                        if (mask)
+                        {
+                            result = gpio[index()].bulkWrite(mask, value, lander);
+
+                            STATISTICS_ADD(index(), writes, (result) ? 1 : 0);
+                        }
+                        else
+                        {
+                            // all pins superseded, only the callbacks are due
+                            minar::Scheduler::postCallback(lander)
+                                .tolerance(1);
+
+                            result = true;
+                        }
+                    }
+                    break;
+
+                case ACTION_DIRECTION:
+                    {
+                        result = gpio[index()].bulkSetDirection(transaction.mask,
+                                                                transaction.value,
+                                                                lander);
+
+                        STATISTICS_ADD(index(), directions, (result) ? 1 : 0);
+                    }
+                    break;
+
+                case ACTION_INTERRUPT:
+                    {
+                        result = gpio[index()].bulkSetInterrupt(transaction.mask,
+                                                                transaction.value,
+                                                                lander);
+
+                        STATISTICS_ADD(index(), interrupts, (result) ? 1 : 0);
+                    }
+                    break;
+
+                default:
+                    break;
+            }
+
+            /* I/O expander command failed, because the device is busy.
+               Repost task into minar to try again later, backing off
+               exponentially so a busy bus does not keep the scheduler
+               spinning. A completion on another location cuts the wait
+               short through wakeup().
+            */
+            if (result == false)
+            {
+                highBurst = previousBurst;
+
+                STATISTICS_ADD(index(), busyRetries, 1);
+
+                FunctionPointer0<void> fp(this, &LocationQueue::retry);
+                retryHandle = minar::Scheduler::postCallback(fp)
+                                .delay(minar::milliseconds(retryDelay))
+                                .tolerance(minar::milliseconds(retryDelay) / 2)
+                                .getHandle();
+
+                retryDelay = (retryDelay > (RETRY_DELAY_MAX / 2)) ? RETRY_DELAY_MAX
+                                                                  : retryDelay * 2;
+            }
+            else
+            {
+                retryDelay = RETRY_DELAY_MIN;
+
+                STATISTICS_START(index());
+            }
+        }
+        else
+        {
+            running = false;
+        }
+    }
+
+    static void updateCache(uint8_t index, uint32_t mask, uint32_t value)
+    {
+        locationValues[index] = (locationValues[index] & ~mask) | (value & mask);
+    }
+
+    static void processIrqQueue(void)
+    {
+        /* clear flag before draining, so writes added while draining
+           post a new callback.
+        */
+        irqQueuePosted = false;
+
+        drainIrqQueue();
+    }
+
+    static void drainIrqQueue(void)
+    {
+        while (irqQueueHead != irqQueueTail)
+        {
+            irqWrite_t& irqWrite = irqQueue[irqQueueHead % IRQ_QUEUE_SIZE];
+
+            uint32_t mask = (uint32_t)1 << irqWrite.pin;
+            Transaction transaction(mask, (irqWrite.value) ? mask : 0, (void (*)(void)) NULL);
+
+            /* stop if queue is full. Draining continues when
+               a transaction completes.
+            */
+            if (getQueue(irqWrite.index).enqueue(transaction) == false)
+            {
+                break;
+            }
+
+            updateCache(irqWrite.index, mask, transaction.value);
+
+            // release slot after it has been read
+            platformMemoryBarrier();
+            irqQueueHead++;
+        }
+    }
+
+    static void dispatchInterrupt(uint8_t index, uint8_t pin, int value)
+    {
+        FunctionPointer1<void, int>& callback = interruptTable[index][pin];
+
+        if (callback)
+        {
+            STATISTICS_ADD(index, interruptsDispatched, 1);
+
+            callback.call(value);
+        }
+        else if (((trackedPins[index] | portInterruptPins[index]) & ((uint32_t)1 << pin)) == 0)
+        {
+            // tracked and port interrupt pins are used without a callback
+            STATISTICS_ADD(index, interruptsDropped, 1);
+        }
+    }
+
+    /*************************************************************************/
+
+    /* Debounced pins are assigned a slot from a fixed pool. Edges on these
+       pins go through the slot instead of directly to the callback, so
+       bouncing contacts produce a single callback.
+
+       DEBOUNCE_WINDOW passes the first edge immediately and ignores further
+       edges for the window. If the pin ended up in the other state when
+       the window closes, that state is passed on and a new window starts.
+
+       DEBOUNCE_INTEGRATOR samples the pin value from the input shadow
+       DEBOUNCE_STEPS times per debounce time, counting up while high and
+       down while low. The state only changes when the counter reaches
+       either end. Sampling stops once the counter rests at the current
+       state, so an idle pin costs nothing.
+
+       Both modes only use the values reported by interrupts and never
+       read from the device.
+    */
+    class DebounceSlot
+    {
+    public:
+        void edge(int value);
+
+        uint8_t index;
+        uint8_t pin;
+        debounce_t mode;
+        uint16_t time;
+
+        /* last value passed on, -1 until the first one */
+        int8_t stable;
+        uint8_t count;
+        minar::callback_handle_t handle;
+
+    private:
+        void windowEnd(void);
+        void integrate(void);
+    };
+
+    /* zero initialized, mode DEBOUNCE_NONE marks a free slot */
+    static DebounceSlot debounceSlots[DEBOUNCE_SLOTS];
+    static uint32_t debouncedPins[LOCATION_SIZE] = { 0 };
+
+    static DebounceSlot* findDebounce(uint8_t index, uint8_t pin)
+    {
+        for (uint8_t idx = 0; idx < DEBOUNCE_SLOTS; idx++)
+        {
+            DebounceSlot& slot = debounceSlots[idx];
+
+            if ((slot.mode != DEBOUNCE_NONE) && (slot.index == index) && (slot.pin == pin))
+            {
+                return &slot;
+            }
+        }
+
+        return NULL;
+    }
+
+    /* Free the slot used by pin, if any, so the pin is no longer debounced. */
+    static void releaseDebounce(uint8_t index, uint8_t pin)
+    {
+        DebounceSlot* slot = findDebounce(index, pin);
+
+        if (slot)
+        {
+            if (slot->handle)
+            {
+                minar::Scheduler::cancelCallback(slot->handle);
+                slot->handle = NULL;
+            }
+
+            slot->mode = DEBOUNCE_NONE;
+            debouncedPins[index] &= ~((uint32_t)1 << pin);
+        }
+    }
+
+    void DebounceSlot::edge(int value)
+    {
+        if (mode == DEBOUNCE_WINDOW)
+        {
+            /* edges inside the window are only recorded in the shadow */
+            if ((handle == NULL) && (value != stable))
+            {
+                stable = value;
+                dispatchInterrupt(index, pin, value);
+
+                FunctionPointer0<void> fp(this, &DebounceSlot::windowEnd);
+                handle = minar::Scheduler::postCallback(fp)
+                            .delay(minar::milliseconds(time))
+                            .tolerance(1)
+                            .getHandle();
+            }
+        }
+        else if (handle == NULL)
+        {
+            uint32_t period = (time >= DEBOUNCE_STEPS) ? time / DEBOUNCE_STEPS : 1;
+
+            FunctionPointer0<void> fp(this, &DebounceSlot::integrate);
+            handle = minar::Scheduler::postCallback(fp)
+                        .period(minar::milliseconds(period))
+                        .tolerance(1)
+                        .getHandle();
+        }
+    }
+
+    void DebounceSlot::windowEnd(void)
+    {
+        handle = NULL;
+
+        int value = (inputValues[index] >> pin) & 0x01;
+
+        /* pin settled in the other state during the window */
+        if (value != stable)
+        {
+            edge(value);
+        }
+    }
+
+    void DebounceSlot::integrate(void)
+    {
+        int value = (inputValues[index] >> pin) & 0x01;
+
+        if (value && (count < DEBOUNCE_STEPS))
+        {
+            count++;
+        }
+        else if ((value == 0) && (count > 0))
+        {
+            count--;
+        }
+
+        int state = (count == DEBOUNCE_STEPS) ? 1 :
+                    (count == 0) ? 0 : stable;
+
+        if (state != stable)
+        {
+            stable = state;
+            dispatchInterrupt(index, pin, state);
+        }
+
+        /* counter at rest, stop sampling until the next edge */
+        if (count == ((stable) ? DEBOUNCE_STEPS : 0))
+        {
+            minar::Scheduler::cancelCallback(handle);
+            handle = NULL;
+        }
+    }
+
+    /*************************************************************************/
+
+    static void dispatchPins(uint8_t index, uint32_t pins, uint32_t values)
+    {
+        /* visit each changed pin, lowest first */
+        while (pins)
+        {
+            uint8_t position = __builtin_ctz(pins);
+            pins &= pins - 1;
+
+            int value = (values >> position) & 0x01;
+
+            if (debouncedPins[index] & ((uint32_t)1 << position))
+            {
+                findDebounce(index, position)->edge(value);
+            }
+            else
+            {
+                dispatchInterrupt(index, position, value);
+            }
+        }
+    }
+
+    /*************************************************************************/
+
+    /* Locations with a port interrupt handler are in batched mode. Changes
+       from any number of expander interrupts are collected until a single
+       MINAR callback delivers them, first to the port handler and then to
+       the per-pin callbacks.
+    */
+    static uint32_t batchPins[LOCATION_SIZE] = { 0 };
+    static bool batchPosted[LOCATION_SIZE] = { false };
+
+    static void processBatch(uint8_t index)
+    {
+        uint32_t pins = batchPins[index];
+        uint32_t values = inputValues[index];
+
+        batchPins[index] = 0;
+        batchPosted[index] = false;
+
+        uint32_t portPins = pins & portInterruptPins[index];
+
+        if (portPins && portInterruptTable[index])
+        {
+            portInterruptTable[index].call(locationAddress[index], portPins, values);
+        }
+
+        dispatchPins(index, pins, values);
+    }
+
+    static void interruptHandler(uint16_t location, uint32_t pins, uint32_t values)
+    {
+        int index = lookupIndex(location);
+
+        if (index >= 0)
+        {
+            inputValues[index] = (inputValues[index] & ~pins) | (values & pins);
+
+            if (portInterruptPins[index])
+            {
+                batchPins[index] |= pins;
+
+                if (batchPosted[index] == false)
+                {
+                    batchPosted[index] = true;
+
+                    FunctionPointer1<void, uint8_t> fp(processBatch);
+                    minar::Scheduler::postCallback(fp.bind(index))
+                        .tolerance(1);
+                }
+            }
+            else
+            {
+                dispatchPins(index, pins, values);
+            }
+        }
+    }
+
+    /*************************************************************************/
+
+    /* Expanders without an interrupt pin are scanned instead. One bulkRead
+       per location and period is compared with the previous one, and pins
+       that changed are passed to interruptHandler as if the expander had
+       reported them.
+    */
+    class LocationScanner
+    {
+    public:
+        void scan(uint8_t index)
+        {
+            /* skip if the previous scan has not completed yet */
+            if (pins && (pending == false))
+            {
+                FunctionPointer1<void, uint32_t> done(this, &LocationScanner::scanDone);
+
+                /* read all pins, so pins added while the read is pending
+                   are seeded too.
+                */
+                pending = getQueue(index).enqueue(Transaction(0xFFFFFFFF, done));
+            }
+        }
+
+        void update(uint32_t mask, bool enable)
+        {
+            pins = (enable) ? (pins | mask) : (pins & ~mask);
+            seeded &= pins;
+        }
+
+        /* pins compared on every scan */
+        uint32_t pins;
+
+        static LocationScanner scanners[LOCATION_SIZE];
+
+    private:
+        void scanDone(uint32_t values)
+        {
+            pending = false;
+
+            /* the first scan of a pin only records its value */
+            uint32_t changed = (values ^ previous) & pins & seeded;
+
+            previous = values;
+            seeded = pins;
+
+            if (changed)
+            {
+                interruptHandler(locationAddress[this - scanners], changed, values);
+            }
+        }
+
+        uint32_t previous;
+        bool pending;
+
+        /* pins with a value in previous */
+        uint32_t seeded;
+    };
+
+    /* zero initialized, so no constructor runs */
+    LocationScanner LocationScanner::scanners[LOCATION_SIZE];
+
+    static minar::callback_handle_t scanHandle = NULL;
+
+    static void scanLocations(void)
+    {
+        for (uint8_t index = 0; index < LOCATION_SIZE; index++)
+        {
+            LocationScanner::scanners[index].scan(index);
+        }
+    }
+
+    /* Add or remove pin from the scan of location index. The periodic
+       callback only runs while at least one pin is scanned.
+    */
+    static void updateScan(uint8_t index, uint32_t mask, bool enable)
+    {
+        LocationScanner::scanners[index].update(mask, enable);
+
+        bool active = false;
+
+        for (uint8_t idx = 0; idx < LOCATION_SIZE; idx++)
+        {
+            active |= (LocationScanner::scanners[idx].pins != 0);
+        }
+
+        if (active && (scanHandle == NULL))
+        {
+            scanHandle = minar::Scheduler::postCallback(scanLocations)
+                            .period(minar::milliseconds(SCAN_PERIOD))
+                            .tolerance(minar::milliseconds(SCAN_PERIOD) / 10)
+                            .getHandle();
+        }
+        else if ((active == false) && scanHandle)
+        {
+            minar::Scheduler::cancelCallback(scanHandle);
+            scanHandle = NULL;
+        }
+    }
+
+}
+#endif // end YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_PRESENT
+
+
+
+/*****************************************************************************/
+/* Public GPIOSwitch API                                                     */
+/*****************************************************************************/
+
+bool GPIOSwitch::readInput(uint8_t pin, uint16_t location, FunctionPointer1<void, int> callback, priority_t priority)
+{
+    bool result = false;
+
+#if YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_PRESENT
+    int index = lookupIndex(location);
+
+    if (index >= 0)
+    {
+        result = getQueue(index).enqueue(Transaction(pin, callback), priority);
+    }
+#else
+    (void) pin;
+    (void) location;
+    (void) callback;
+    (void) priority;
+#endif
+
+    return result;
+}
+
+int GPIOSwitch::readOutput(uint8_t pin, uint16_t location)
+{
+    int result = -1;
+
+#if YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_PRESENT
+    int index = lookupIndex(location);
+
+    if (index >= 0)
+    {
+        result = (locationValues[index] >> pin) & 0x01;
+    }
+#else
+    (void) pin;
+    (void) location;
+#endif
+
+    return result;
+}
+
+bool GPIOSwitch::writeOutputIrq(uint8_t pin, uint16_t location, int8_t value)
+{
+    bool result = false;
+
+#if YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_PRESENT
+    /* outside interrupt context the queue can be used directly */
+    if (platformInInterrupt() == false)
+    {
+        return writeOutputTask(pin, location, value);
+    }
+
+    int index = lookupIndex(location);
+
+    if (index >= 0)
+    {
+        uint8_t tail = irqQueueTail;
+
+        // drop write if ring is full
+        if ((uint8_t)(tail - irqQueueHead) < IRQ_QUEUE_SIZE)
+        {
+            irqWrite_t& irqWrite = irqQueue[tail % IRQ_QUEUE_SIZE];
+            irqWrite.pin = pin;
+            irqWrite.index = index;
+            irqWrite.value = value;
+
+            // publish slot after it has been written
+            platformMemoryBarrier();
+            irqQueueTail = tail + 1;
+
+            if (irqQueuePosted == false)
+            {
+                irqQueuePosted = true;
+
+                minar::Scheduler::postCallback(processIrqQueue)
+                    .tolerance(1);
+            }
+
+            result = true;
+        }
+    }
+#else
+    (void) pin;
+    (void) location;
+    (void) value;
+#endif
+
+    return result;
+}
+
+bool GPIOSwitch::writeOutputTask(uint8_t pin, uint16_t location, int8_t value, priority_t priority)
+{
+    bool result = false;
+
+#if YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_PRESENT
+    int index = lookupIndex(location);
+
+    if (index >= 0)
+    {
+        uint32_t mask = (uint32_t)1 << pin;
+        Transaction transaction(mask, (value) ? mask : 0, (void (*)(void)) NULL);
+
+        result = getQueue(index).enqueue(transaction, priority);
+
+        // update cache
+        if (result)
+        {
+            updateCache(index, mask, transaction.value);
+        }
+    }
+#else
+    (void) pin;
+    (void) location;
+    (void) value;
+    (void) priority;
+#endif
+
+    return result;
+}
+
+bool GPIOSwitch::writeOutput(uint8_t pin, uint16_t location, int8_t value, FunctionPointer0<void> callback, priority_t priority)
+{
+    bool result = false;
+
+#if YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_PRESENT
+    int index = lookupIndex(location);
+
+    if (index >= 0)
+    {
+        uint32_t mask = (uint32_t)1 << pin;
+        Transaction transaction(mask, (value) ? mask : 0, callback);
+
+        result = getQueue(index).enqueue(transaction, priority);
+
+        // update cache
+        if (result)
+        {
+            updateCache(index, mask, transaction.value);
+        }
+    }
+#else
+    (void) pin;
+    (void) location;
+    (void) value;
+    (void) callback;
+    (void) priority;
+#endif
+
+    return result;
+}
+
+bool GPIOSwitch::setDirection(uint8_t pin, uint16_t location, int8_t direction, priority_t priority)
+{
+    bool result = false;
+
+#if YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_PRESENT
+    int index = lookupIndex(location);
+
+    if (index >= 0)
+    {
+        result = getQueue(index).enqueue(Transaction(ACTION_DIRECTION, (uint32_t)1 << pin, (direction) ? 0xFFFFFFFF : 0), priority);
+    }
+#else
+    (void) pin;
+    (void) location;
+    (void) direction;
+    (void) priority;
+#endif
+
+    return result;
+}
+
+bool GPIOSwitch::configureOutput(uint8_t pin, uint16_t location, int8_t value)
+{
+    uint32_t mask = (uint32_t)1 << pin;
+
+    return configurePortOutput(mask, (value) ? mask : 0, location);
+}
+
+bool GPIOSwitch::configureInput(uint8_t pin, uint16_t location)
+{
+    return configurePortInput((uint32_t)1 << pin, location);
+}
+
+bool GPIOSwitch::configurePortOutput(uint32_t mask, uint32_t value, uint16_t location)
+{
+    bool result = false;
+
+#if YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_PRESENT
+    int index = lookupIndex(location);
+
+    if (index >= 0)
+    {
+        getQueue(index).configure(ACTION_WRITE, mask, value);
+        getQueue(index).configure(ACTION_DIRECTION, mask, mask);
+
+        updateCache(index, mask, value);
+
+        result = true;
+    }
+#else
+    (void) mask;
+    (void) value;
+    (void) location;
+#endif
+
+    return result;
+}
+
+bool GPIOSwitch::configurePortInput(uint32_t mask, uint16_t location)
+{
+    bool result = false;
+
+#if YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_PRESENT
+    int index = lookupIndex(location);
+
+    if (index >= 0)
+    {
+        getQueue(index).configure(ACTION_DIRECTION, mask, 0);
+
+        result = true;
+    }
+#else
+    (void) mask;
+    (void) location;
+#endif
+
+    return result;
+}
+
+bool GPIOSwitch::readPort(uint16_t location, FunctionPointer1<void, uint32_t> callback, uint32_t mask, priority_t priority)
+{
+    bool result = false;
+
+#if YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_PRESENT
+    int index = lookupIndex(location);
+
+    if (index >= 0)
+    {
+        result = getQueue(index).enqueue(Transaction(mask, callback), priority);
+    }
+#else
+    (void) location;
+    (void) callback;
+    (void) mask;
+    (void) priority;
+#endif
 
-        FunctionPointer1<void, int> read;
-        FunctionPointer0<void> write;
-    };
+    return result;
+}
 
-    static void enqueueTransaction(SharedPointer<Transaction>);
-    static void processQueue(void);
-    static void processQueueLander(void);
-    static void processQueueDone(uint32_t);
-    static std::queue<SharedPointer<Transaction > > sendQueue;
-    static minar::callback_handle_t processQueueHandle = NULL;
+uint32_t GPIOSwitch::readOutputPort(uint16_t location)
+{
+    uint32_t result = 0;
 
-    /*************************************************************************/
+#if YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_PRESENT
+    int index = lookupIndex(location);
 
-    typedef std::map<uint32_t, FunctionPointer1<void, int> > callbackMap_t;
-    typedef callbackMap_t::iterator callbackIterator_t;
+    if (index >= 0)
+    {
+        result = locationValues[index];
+    }
+#else
+    (void) location;
+#endif
 
-    static callbackMap_t interruptMap;
+    return result;
+}
 
-    /*************************************************************************/
+bool GPIOSwitch::writePort(uint32_t mask, uint32_t value, uint16_t location, FunctionPointer0<void> callback, priority_t priority)
+{
+    bool result = false;
 
-    static void enqueueTransaction(SharedPointer<Transaction> transaction)
+#if YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_PRESENT
+    int index = lookupIndex(location);
+
+    if (index >= 0)
     {
-        sendQueue.push(transaction);
+        result = getQueue(index).enqueue(Transaction(mask, value, callback), priority);
 
-        if (processQueueHandle == NULL)
+        // update cache
+        if (result)
         {
-            processQueueHandle = minar::Scheduler::postCallback(processQueue)
-                                    .tolerance(1)
-                                    .getHandle();
+            updateCache(index, mask, value);
         }
     }
+#else
+    (void) mask;
+    (void) value;
+    (void) location;
+    (void) callback;
+    (void) priority;
+#endif
+
+    return result;
+}
+
+bool GPIOSwitch::setPortDirection(uint32_t mask, uint32_t direction, uint16_t location, priority_t priority)
+{
+    bool result = false;
+
+#if YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_PRESENT
+    int index = lookupIndex(location);
 
-    static void processQueueLander(void)
+    if (index >= 0)
     {
-        processQueueDone(0);
+        result = getQueue(index).enqueue(Transaction(ACTION_DIRECTION, mask, direction), priority);
     }
+#else
+    (void) mask;
+    (void) direction;
+    (void) location;
+    (void) priority;
+#endif
 
-    static void processQueueDone(uint32_t values)
-    {
-        SharedPointer<Transaction> transaction = sendQueue.front();
-        sendQueue.pop();
+    return result;
+}
 
-        switch (transaction->action)
-        {
-            case ACTION_READ:
-                {
-                    if (transaction->read)
-                    {
-                        int value = (values >> transaction->pin) & 0x01;
-                        minar::Scheduler::postCallback(transaction->read.bind(value))
-                            .tolerance(1);
-                    }
-                }
-                break;
 
-            case ACTION_WRITE:
-                {
-                    if (transaction->write)
-                    {
-                        minar::Scheduler::postCallback(transaction->write)
-                            .tolerance(1);
-                    }
-                }
 
-            case ACTION_DIRECTION:
-            case ACTION_INTERRUPT:
-            default:
-                break;
-        }
+/*****************************************************************************/
+/* Public GPIOSwitch API                                                     */
+/*****************************************************************************/
 
-        if (sendQueue.size() > 0)
-        {
-            processQueueHandle = minar::Scheduler::postCallback(processQueue)
-                                    .tolerance(1)
-                                    .getHandle();
-        }
-        else
-        {
-            /* clear task handle */
-            processQueueHandle = NULL;
-        }
-    }
+bool GPIOSwitch::enableInterrupt(uint8_t pin, uint16_t location, FunctionPointer1<void, int> callback)
+{
+    bool result = false;
+
+#if YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_PRESENT
+    int index = lookupIndex(location);
 
-    static void processQueue(void)
+    if ((index >= 0) && (pin < 32))
     {
-        // only process if queue is not empty
-        if (sendQueue.size() > 0)
-        {
-            bool result = false;
+        // enable interrupt together with other pending configuration
+        getQueue(index).configure(ACTION_INTERRUPT, (uint32_t)1 << pin, 0xFFFFFFFF);
 
-            /* get next transaction */
-            SharedPointer<Transaction> transaction = sendQueue.front();
+        // store external callback function
+        interruptTable[index][pin] = callback;
 
-            switch(transaction->action)
-            {
-                case ACTION_READ:
-                    {
-                        result = gpio[transaction->index].bulkRead(processQueueDone);
-                    }
-                    break;
+        // register local callback function
+        gpio[index].setInterruptHandler(GPIOSwitch::interruptHandler);
 
-                case ACTION_WRITE:
-                    {
-                        result = gpio[transaction->index]
-                                    .bulkWrite(((uint32_t)1 << transaction->pin),
-                                               ((uint32_t)transaction->parameter << transaction->pin),
-                                               processQueueLander);
-                    }
-                    break;
+        // without interrupt pin, changes are found by scanning
+        if (locationHasIrq[index] == false)
+        {
+            updateScan(index, (uint32_t)1 << pin, true);
+        }
 
-                case ACTION_DIRECTION:
-                    {
-                        result = gpio[transaction->index]
-                                    .bulkSetDirection(((uint32_t)1 << transaction->pin),
-                                                      ((uint32_t)transaction->parameter << transaction->pin),
-                                                      processQueueLander);
-                    }
-                    break;
+        result = true;
+    }
+#else
+    (void) pin;
+    (void) location;
+    (void) callback;
+#endif
 
-                case ACTION_INTERRUPT:
-                    {
-                        result = gpio[transaction->index]
-                                    .bulkSetInterrupt(((uint32_t)1 << transaction->pin),
-                                                      ((uint32_t)transaction->parameter << transaction->pin),
-                                                      processQueueLander);
-                    }
-                    break;
+    return result;
 
-                default:
-                    break;
-            }
+}
 
-            /* I/O expander command failed, because the device is busy.
-               Repost task into minar to try again later.
-            */
-            if (result == false)
-            {
-                processQueueHandle = minar::Scheduler::postCallback(processQueue)
-                                        .getHandle();
-            }
-        }
-    }
+bool GPIOSwitch::disableInterrupt(uint8_t pin, uint16_t location)
+{
+    bool result = false;
 
-    static void interruptHandler(uint16_t location, uint32_t pins, uint32_t values)
+#if YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_PRESENT
+    int index = lookupIndex(location);
+
+    if ((index >= 0) && (pin < 32))
     {
-        for (uint8_t position = 0; position < 32; position++)
-        {
-            uint8_t pinbit = (pins >> position) & 0x01;
+        uint32_t mask = (uint32_t)1 << pin;
 
-            /* Note: the interruptMapIndex is calculated based on the (pin) position
-            */
-            if (pinbit)
-            {
-                uint32_t interruptMapIndex = ((uint32_t)location << 16) | ((uint32_t)0x01 << position);
-                callbackIterator_t result = interruptMap.find(interruptMapIndex);
+        // pins used by a port interrupt stay enabled
+        uint32_t disable = mask & ~portInterruptPins[index];
 
-                if (result != interruptMap.end())
-                {
-                    result->second.call((values >> position) & 0x01);
-                }
-            }
-        }
-    }
+        getQueue(index).configure(ACTION_INTERRUPT, disable, 0);
 
-}
-#endif // end YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_PRESENT
+        // remove external callback function
+        interruptTable[index][pin] = FunctionPointer1<void, int>();
+        trackedPins[index] &= ~mask;
+        trackedValid[index] &= ~mask;
 
+        releaseDebounce(index, pin);
 
+        if (locationHasIrq[index] == false)
+        {
+            updateScan(index, disable, false);
+        }
 
+        result = true;
+    }
+#else
+    (void) pin;
+    (void) location;
+#endif
 
-/*****************************************************************************/
-/* Public GPIOSwitch API                                                     */
-/*****************************************************************************/
+    return result;
+
+}
 
-bool GPIOSwitch::readInput(uint8_t pin, uint16_t location, FunctionPointer1<void, int> callback)
+bool GPIOSwitch::enablePortInterrupt(uint32_t mask, uint16_t location, FunctionPointer3<void, uint16_t, uint32_t, uint32_t> callback)
 {
     bool result = false;
 
 #if YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_PRESENT
-    for (uint8_t index = 0; index < LOCATION_SIZE; index++)
+    int index = lookupIndex(location);
+
+    /* one callback per location. Callbacks can not be compared, so a
+       callback is only accepted while none is registered, and an empty
+       callback adds pins to the registered one.
+    */
+    bool registered = (index >= 0) && (portInterruptPins[index] != 0);
+
+    if ((index >= 0) && (registered != (bool) callback))
     {
-        if (location == locationAddress[index])
+        // all pins are set to input and enabled in a single transaction each
+        getQueue(index).configure(ACTION_DIRECTION, mask, 0);
+        getQueue(index).configure(ACTION_INTERRUPT, mask, 0xFFFFFFFF);
+
+        if (callback)
         {
-            SharedPointer<Transaction> transaction(new Transaction(pin, index, callback));
+            portInterruptTable[index] = callback;
+        }
 
-            FunctionPointer1<void, SharedPointer<Transaction> > fp(enqueueTransaction);
-            minar::Scheduler::postCallback(fp.bind(transaction))
-                .tolerance(1);
+        portInterruptPins[index] |= mask;
 
-            result = true;
-            break;
+        gpio[index].setInterruptHandler(GPIOSwitch::interruptHandler);
+
+        if (locationHasIrq[index] == false)
+        {
+            updateScan(index, mask, true);
         }
+
+        result = true;
     }
 #else
-    (void) pin;
+    (void) mask;
     (void) location;
     (void) callback;
 #endif
@@ -302,206 +1929,274 @@ bool GPIOSwitch::readInput(uint8_t pin, uint16_t location, FunctionPointer1<void
     return result;
 }
 
-int GPIOSwitch::readOutput(uint8_t pin, uint16_t location)
+bool GPIOSwitch::disablePortInterrupt(uint32_t mask, uint16_t location)
 {
-    int result = -1;
+    bool result = false;
 
 #if YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_PRESENT
-    for (uint8_t index = 0; index < LOCATION_SIZE; index++)
+    int index = lookupIndex(location);
+
+    if (index >= 0)
     {
-        if (location == locationAddress[index])
+        /* keep interrupts enabled on pins still used by per-pin
+           callbacks or input tracking.
+        */
+        uint32_t disable = mask & ~trackedPins[index];
+
+        for (uint8_t pin = 0; pin < 32; pin++)
+        {
+            if (interruptTable[index][pin])
+            {
+                disable &= ~((uint32_t)1 << pin);
+            }
+        }
+
+        getQueue(index).configure(ACTION_INTERRUPT, disable, 0);
+
+        portInterruptPins[index] &= ~mask;
+
+        if (portInterruptPins[index] == 0)
+        {
+            portInterruptTable[index] = FunctionPointer3<void, uint16_t, uint32_t, uint32_t>();
+        }
+
+        if (locationHasIrq[index] == false)
         {
-            result = (locationValues[index] >> pin) & 0x01;
-            break;
+            updateScan(index, disable, false);
         }
+
+        result = true;
     }
 #else
-    (void) pin;
+    (void) mask;
     (void) location;
 #endif
 
     return result;
 }
 
-void GPIOSwitch::writeOutputIrq(uint8_t pin, uint16_t location, int8_t value)
+bool GPIOSwitch::trackInput(uint8_t pin, uint16_t location)
 {
-    FunctionPointer3<void, uint8_t, uint16_t, int8_t> fp(GPIOSwitch::writeOutputTask);
-    minar::Scheduler::postCallback(fp.bind(pin, location, value))
-        .tolerance(1);
-}
+    bool result = false;
 
-void GPIOSwitch::writeOutputTask(uint8_t pin, uint16_t location, int8_t value)
-{
 #if YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_PRESENT
-    for (uint8_t index = 0; index < LOCATION_SIZE; index++)
+    int index = lookupIndex(location);
+
+    if (index >= 0)
     {
-        if (location == locationAddress[index])
+        uint32_t mask = (uint32_t)1 << pin;
+
+        if (trackedPins[index] & mask)
+        {
+            result = true;
+        }
+        else
         {
-            // construct transaction
-            SharedPointer<Transaction> transaction(new Transaction(pin, index, value, (void (*)(void)) NULL));
+            /* enable interrupt first, then seed the value with a read, so
+               no change can be missed between the two.
+            */
+            getQueue(index).configure(ACTION_INTERRUPT, mask, 0xFFFFFFFF);
 
-            FunctionPointer1<void, SharedPointer<Transaction> > fp(enqueueTransaction);
-            minar::Scheduler::postCallback(fp.bind(transaction))
-                .tolerance(1);
+            /* the read carries the pins it seeds in its value, so reads
+               sent before the interrupt was enabled do not count.
+            */
+            result = getQueue(index).enqueue(Transaction(ACTION_READ, mask, mask));
 
-            // update cache
-            if (value)
+            if (result)
             {
-                locationValues[index] |= (uint32_t)value << pin;
+                trackedPins[index] |= mask;
+
+                gpio[index].setInterruptHandler(GPIOSwitch::interruptHandler);
+
+                if (locationHasIrq[index] == false)
+                {
+                    updateScan(index, mask, true);
+                }
             }
-            else
+            else if ((interruptTable[index][pin] == false) &&
+                     ((portInterruptPins[index] & mask) == 0))
             {
-                locationValues[index] &= ~((uint32_t)1 << pin);
+                // queue full, withdraw the interrupt enable collected above
+                getQueue(index).configure(ACTION_INTERRUPT, mask, 0);
             }
-            break;
         }
     }
 #else
     (void) pin;
     (void) location;
-    (void) value;
 #endif
+
+    return result;
 }
 
-bool GPIOSwitch::writeOutput(uint8_t pin, uint16_t location, int8_t value, FunctionPointer0<void> callback)
+int GPIOSwitch::readInputCached(uint8_t pin, uint16_t location, uint32_t maxAge)
 {
-    bool result = false;
+    int result = -1;
 
 #if YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_PRESENT
-    for (uint8_t index = 0; index < LOCATION_SIZE; index++)
-    {
-        if (location == locationAddress[index])
-        {
-            // construct transaction
-            SharedPointer<Transaction> transaction(new Transaction(pin, index, value, callback));
+    int index = lookupIndex(location);
 
-            FunctionPointer1<void, SharedPointer<Transaction> > fp(enqueueTransaction);
-            minar::Scheduler::postCallback(fp.bind(transaction))
-                .tolerance(1);
+    if (index >= 0)
+    {
+        uint32_t mask = (uint32_t)1 << pin;
 
-            // update cache
-            if (value)
-            {
-                locationValues[index] |= (uint32_t)value << pin;
-            }
-            else
-            {
-                locationValues[index] &= ~((uint32_t)1 << pin);
-            }
+        bool fresh = (maxAge > 0) && inputValid[index] &&
+                     ((minar::tick_t)(minar::Scheduler::getTime() - inputTime[index]) <= minar::milliseconds(maxAge));
 
-            result = true;
-            break;
+        if ((trackedValid[index] & mask) || fresh)
+        {
+            result = (inputValues[index] & mask) ? 1 : 0;
         }
     }
 #else
     (void) pin;
     (void) location;
-    (void) value;
-    (void) callback;
+    (void) maxAge;
 #endif
 
     return result;
 }
 
-bool GPIOSwitch::setDirection(uint8_t pin, uint16_t location, int8_t direction)
+bool GPIOSwitch::getInputShadow(uint16_t location, uint32_t& values, minar::tick_t& timestamp)
 {
     bool result = false;
 
 #if YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_PRESENT
-    for (uint8_t index = 0; index < LOCATION_SIZE; index++)
-    {
-        if (location == locationAddress[index])
-        {
-            SharedPointer<Transaction> transaction(new Transaction(ACTION_DIRECTION, pin, index, direction));
+    int index = lookupIndex(location);
 
-            FunctionPointer1<void, SharedPointer<Transaction> > fp(enqueueTransaction);
-            minar::Scheduler::postCallback(fp.bind(transaction))
-                .tolerance(1);
+    if ((index >= 0) && inputValid[index])
+    {
+        values = inputValues[index];
+        timestamp = inputTime[index];
 
-            result = true;
-            break;
-        }
+        result = true;
     }
 #else
-    (void) pin;
     (void) location;
-    (void) direction;
+    (void) values;
+    (void) timestamp;
 #endif
 
     return result;
 }
 
-
-
-/*****************************************************************************/
-/* Public GPIOSwitch API                                                     */
-/*****************************************************************************/
-
-bool GPIOSwitch::enableInterrupt(uint8_t pin, uint16_t location, FunctionPointer1<void, int> callback)
+bool GPIOSwitch::setDebounce(uint8_t pin, uint16_t location, debounce_t mode, uint16_t time)
 {
     bool result = false;
 
 #if YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_PRESENT
-    for (uint8_t index = 0; index < LOCATION_SIZE; index++)
+    int index = lookupIndex(location);
+
+    if ((index >= 0) && (pin < 32))
     {
-        if (location == locationAddress[index])
-        {
-            // schedule transaction for enabling interrupt
-            SharedPointer<Transaction> transaction(new Transaction(ACTION_INTERRUPT, pin, index, 1));
+        uint32_t mask = (uint32_t)1 << pin;
 
-            FunctionPointer1<void, SharedPointer<Transaction> > fp(enqueueTransaction);
-            minar::Scheduler::postCallback(fp.bind(transaction))
-                .tolerance(1);
+        releaseDebounce(index, pin);
 
-            // store external callback function
-            uint32_t interruptMapIndex = ((uint32_t)location << 16) | ((uint32_t)0x01 << pin);
-            interruptMap[interruptMapIndex] = callback;
+        if ((mode == DEBOUNCE_NONE) || (time == 0))
+        {
+            result = true;
+        }
+        else
+        {
+            DebounceSlot* slot = NULL;
 
-            // register local callback function
-            gpio[index].setInterruptHandler(GPIOSwitch::interruptHandler);
+            for (uint8_t idx = 0; (slot == NULL) && (idx < DEBOUNCE_SLOTS); idx++)
+            {
+                if (debounceSlots[idx].mode == DEBOUNCE_NONE)
+                {
+                    slot = &debounceSlots[idx];
+                }
+            }
 
-            result = true;
-            break;
+            if (slot)
+            {
+                /* the pin value may not have been read yet, so the first
+                   edge always passes and the integrator starts halfway.
+                */
+                slot->index = index;
+                slot->pin = pin;
+                slot->mode = mode;
+                slot->time = time;
+                slot->stable = -1;
+                slot->count = DEBOUNCE_STEPS / 2;
+                slot->handle = NULL;
+
+                debouncedPins[index] |= mask;
+
+                result = true;
+            }
         }
     }
 #else
     (void) pin;
     (void) location;
-    (void) callback;
+    (void) mode;
+    (void) time;
 #endif
 
     return result;
-
 }
 
-bool GPIOSwitch::disableInterrupt(uint8_t pin, uint16_t location)
+bool GPIOSwitch::resynchronize(uint16_t location)
 {
     bool result = false;
 
 #if YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_PRESENT
-    for (uint8_t index = 0; index < LOCATION_SIZE; index++)
+    int index = lookupIndex(location);
+
+    if (index >= 0)
     {
-        if (location == locationAddress[index])
-        {
-            SharedPointer<Transaction> transaction(new Transaction(ACTION_INTERRUPT, pin, index, 0));
+        result = getQueue(index).resynchronize();
+    }
+#else
+    (void) location;
+#endif
 
-            FunctionPointer1<void, SharedPointer<Transaction> > fp(enqueueTransaction);
-            minar::Scheduler::postCallback(fp.bind(transaction))
-                .tolerance(1);
+    return result;
+}
 
-            // remove external callback function
-            uint32_t interruptMapIndex = ((uint32_t)location << 16) | ((uint32_t)0x01 << pin);
-            interruptMap.erase(interruptMapIndex);
+bool GPIOSwitch::getStatistics(uint16_t location, statistics_t& result)
+{
+    bool found = false;
 
-            result = true;
-            break;
-        }
+#if YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_PRESENT && YOTTA_CFG_WRD_GPIO_SWITCH_STATISTICS
+    int index = lookupIndex(location);
+
+    if (index >= 0)
+    {
+        result = statistics[index];
+        found = true;
     }
 #else
-    (void) pin;
     (void) location;
+    (void) result;
 #endif
 
-    return result;
+    return found;
+}
+
+bool GPIOSwitch::resetStatistics(uint16_t location)
+{
+    bool found = false;
+
+#if YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_PRESENT && YOTTA_CFG_WRD_GPIO_SWITCH_STATISTICS
+    int index = lookupIndex(location);
+
+    if (index >= 0)
+    {
+        // current queue depth is state, not a counter
+        uint16_t queueDepth = statistics[index].queueDepth;
+
+        statistics[index] = statistics_t();
+        statistics[index].queueDepth = queueDepth;
+        statistics[index].queueDepthMax = queueDepth;
+
+        found = true;
+    }
+#else
+    (void) location;
+#endif
 
+    return found;
 }
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef __GPIO_SWITCH_PLATFORM_H__
+#define __GPIO_SWITCH_PLATFORM_H__
+
+/*
+    Processor intrinsics used by the interrupt write ring. Host builds
+    (see test/host) have no interrupt context and run every callback
+    from the scheduler loop.
+*/
+#if defined(TARGET_LIKE_MBED)
+
+static inline bool platformInInterrupt(void)
+{
+    return (__get_IPSR() != 0);
+}
+
+static inline void platformMemoryBarrier(void)
+{
+    __DMB();
+}
+
+#else
+
+static inline bool platformInInterrupt(void)
+{
+    return false;
+}
+
+static inline void platformMemoryBarrier(void)
+{
+    __sync_synchronize();
+}
+
+#endif
+
+#endif // __GPIO_SWITCH_PLATFORM_H__
@@ -18,6 +18,8 @@
 #include "wrd-gpio-switch/InterruptInEx.h"
 #include "wrd-gpio-switch/GPIOSwitch.h"
 
+#include <new>
+
 InterruptInEx::InterruptInEx(uint32_t _pin, uint32_t _location)
     :   pin(_pin),
         location(_location),
@@ -25,7 +27,26 @@ InterruptInEx::InterruptInEx(uint32_t _pin, uint32_t _location)
 {
     if ((location == 0) && ((PinName) pin != NC))
     {
-        local = SharedPointer<InterruptIn>(new InterruptIn((PinName) pin));
+        new (localStorage) InterruptIn((PinName) pin);
+    }
+}
+
+InterruptInEx::~InterruptInEx()
+{
+    if (location)
+    {
+        // callbacks refer to this object
+        if (riseCallback || fallCallback)
+        {
+            GPIOSwitch::disableInterrupt(pin, location);
+        }
+
+        // free the debounce slot, even if no callback was set
+        GPIOSwitch::setDebounce(pin, location, GPIOSwitch::DEBOUNCE_NONE, 0);
+    }
+    else if ((PinName) pin != NC)
+    {
+        local()->~InterruptIn();
     }
 }
 
@@ -37,7 +58,7 @@ int InterruptInEx::read()
     }
     else
     {
-        return local->read();
+        return local()->read();
     }
 }
 
@@ -91,7 +112,7 @@ void InterruptInEx::mode(PinMode pull)
     }
     else
     {
-        local->mode(pull);
+        local()->mode(pull);
     }
 }
 
@@ -104,7 +125,7 @@ void InterruptInEx::enable_irq()
     }
     else
     {
-        local->enable_irq();
+        local()->enable_irq();
     }
 }
 
@@ -116,8 +137,20 @@ void InterruptInEx::disable_irq()
     }
     else
     {
-        local->disable_irq();
+        local()->disable_irq();
+    }
+}
+
+bool InterruptInEx::setDebounce(GPIOSwitch::debounce_t mode, uint16_t time)
+{
+    bool result = false;
+
+    if (location)
+    {
+        result = GPIOSwitch::setDebounce(pin, location, mode, time);
     }
+
+    return result;
 }
 
 void InterruptInEx::interruptHandler(int _value)
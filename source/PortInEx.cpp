@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "wrd-gpio-switch/PortInEx.h"
+#include "wrd-gpio-switch/GPIOSwitch.h"
+
+PortInEx::PortInEx(uint32_t _location, uint32_t _mask)
+    :   location(_location),
+        mask(_mask),
+        cache(0)
+{
+    GPIOSwitch::configurePortInput(mask, location);
+}
+
+int PortInEx::read(void)
+{
+    // schedule cache to be updated
+    FunctionPointer1<void, uint32_t> fp(this, &PortInEx::updateCache);
+    GPIOSwitch::readPort(location, fp, mask);
+
+    return cache;
+}
+
+void PortInEx::read(FunctionPointer1<void, uint32_t> callback, GPIOSwitch::priority_t priority)
+{
+    GPIOSwitch::readPort(location, callback, mask, priority);
+}
+
+void PortInEx::updateCache(uint32_t value)
+{
+    cache = value;
+}
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "wrd-gpio-switch/PortOutEx.h"
+#include "wrd-gpio-switch/GPIOSwitch.h"
+
+PortOutEx::PortOutEx(uint32_t _location, uint32_t _mask)
+    :   location(_location),
+        mask(_mask)
+{
+    GPIOSwitch::configurePortOutput(mask, 0, location);
+}
+
+int PortOutEx::read()
+{
+    return GPIOSwitch::readOutputPort(location) & mask;
+}
+
+void PortOutEx::write(int value)
+{
+    GPIOSwitch::writePort(mask, value, location, (void (*)(void)) NULL);
+}
+
+void PortOutEx::write(int value, FunctionPointer0<void> callback, GPIOSwitch::priority_t priority)
+{
+    GPIOSwitch::writePort(mask, value, location, callback, priority);
+}
@@ -0,0 +1,400 @@
+/*
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * GPIOSwitch benchmark.
+ *
+ * Drives DigitalOutEx, DigitalInEx and InterruptInEx through representative
+ * workloads and prints throughput, enqueue-to-completion latency, peak number
+ * of outstanding operations and heap high-water mark for each. With
+ * wrd-gpio-switch.statistics enabled it also prints the peak command queue
+ * depth.
+ *
+ * Pins 0-7 on each expander are used as outputs and pins 8-15 as inputs.
+ * The interrupt and busy bus workloads need the simulated expander
+ * (wrd-gpio-switch.simulator) to generate input changes and bus delays, and
+ * the mixed workload needs at least two expanders.
+ */
+
+#include "mbed-drivers/mbed.h"
+
+#include "wrd-gpio-switch/DigitalOutEx.h"
+#include "wrd-gpio-switch/DigitalInEx.h"
+#include "wrd-gpio-switch/InterruptInEx.h"
+
+#if YOTTA_CFG_WRD_GPIO_SWITCH_SIMULATOR
+#include "wrd-gpio-switch/GPIOExpanderSimulator.h"
+#endif
+
+#include <algorithm>
+#include <malloc.h>
+
+#if YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_PRESENT
+#else
+#error missing WRD GPIO expander configuration
+#endif
+
+#define PIN_COUNT       8
+#define ITERATIONS      32
+#define SAMPLE_MAX      (ITERATIONS * PIN_COUNT * 4)
+
+#define LOCATION_0      YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_GPIO0_I2C_ADDRESS
+#if (YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_SIZE > 1)
+#define LOCATION_1      YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_GPIO1_I2C_ADDRESS
+#define LOCATION_COUNT  2
+#else
+#define LOCATION_COUNT  1
+#endif
+
+#define BUSY_LATENCY    1   // ms per simulated command in the busy bus workload
+#define BUSY_INTERVAL   4   // every 4th simulated command is reported busy
+
+static DigitalOutEx* outputs[LOCATION_COUNT][PIN_COUNT];
+static DigitalInEx* inputs[LOCATION_COUNT][PIN_COUNT];
+static InterruptInEx* interrupts[PIN_COUNT];
+
+static const uint16_t locations[LOCATION_COUNT] = {
+    LOCATION_0,
+#if (LOCATION_COUNT > 1)
+    LOCATION_1,
+#endif
+};
+
+static Timer timer;
+
+/*****************************************************************************/
+/* Measurements                                                              */
+/*****************************************************************************/
+
+/* Operations on one location complete in the order they were issued,
+   so start times are kept in a FIFO per location.
+*/
+static uint32_t startTimes[LOCATION_COUNT][SAMPLE_MAX];
+static uint16_t startHead[LOCATION_COUNT];
+static uint16_t startTail[LOCATION_COUNT];
+
+static uint32_t latencies[SAMPLE_MAX];
+static uint16_t latencyCount;
+
+static uint32_t outstanding;
+static uint32_t outstandingPeak;
+static uint32_t heapPeak;
+static uint32_t benchmarkStart;
+
+static void (*iterationFunction)(void);
+static uint16_t iteration;
+
+static void iterationDone(void);
+
+static void sampleHeap(void)
+{
+    struct mallinfo info = mallinfo();
+
+    if ((uint32_t) info.uordblks > heapPeak)
+    {
+        heapPeak = info.uordblks;
+    }
+}
+
+static void issued(uint8_t location)
+{
+    startTimes[location][startTail[location] % SAMPLE_MAX] = timer.read_us();
+    startTail[location]++;
+
+    outstanding++;
+
+    if (outstanding > outstandingPeak)
+    {
+        outstandingPeak = outstanding;
+    }
+
+    sampleHeap();
+}
+
+static void completed(uint8_t location)
+{
+    uint32_t start = startTimes[location][startHead[location] % SAMPLE_MAX];
+    startHead[location]++;
+
+    if (latencyCount < SAMPLE_MAX)
+    {
+        latencies[latencyCount++] = timer.read_us() - start;
+    }
+
+    sampleHeap();
+
+    outstanding--;
+
+    if (outstanding == 0)
+    {
+        minar::Scheduler::postCallback(iterationDone);
+    }
+}
+
+static void writeDone0(void)
+{
+    completed(0);
+}
+
+static void readDone0(int)
+{
+    completed(0);
+}
+
+#if (LOCATION_COUNT > 1)
+static void writeDone1(void)
+{
+    completed(1);
+}
+
+static void readDone1(int)
+{
+    completed(1);
+}
+#endif
+
+/*****************************************************************************/
+/* Workloads                                                                 */
+/*****************************************************************************/
+
+/* One write to every output pin. */
+static void burstWrite(void)
+{
+    for (uint8_t pin = 0; pin < PIN_COUNT; pin++)
+    {
+        issued(0);
+        outputs[0][pin]->write(iteration & 0x01, writeDone0);
+    }
+}
+
+/* Repeated reads of the same input. */
+static void pollingRead(void)
+{
+    for (uint8_t pin = 0; pin < PIN_COUNT; pin++)
+    {
+        issued(0);
+        inputs[0][0]->read(readDone0);
+    }
+}
+
+#if YOTTA_CFG_WRD_GPIO_SWITCH_SIMULATOR
+static void interruptDone(void)
+{
+    completed(0);
+}
+
+/* All inputs change at once. */
+static void interruptStorm(void)
+{
+    for (uint8_t pin = 0; pin < PIN_COUNT; pin++)
+    {
+        issued(0);
+    }
+
+    GPIOExpanderSimulator* simulator = GPIOExpanderSimulator::find(LOCATION_0);
+    simulator->setInput(0xFF00, (iteration & 0x01) ? 0 : 0xFF00);
+}
+
+/* Writes and reads on a slow expander that is regularly busy. */
+static void busyBus(void)
+{
+    for (uint8_t pin = 0; pin < PIN_COUNT; pin++)
+    {
+        issued(0);
+        outputs[0][pin]->write(iteration & 0x01, writeDone0);
+
+        issued(0);
+        inputs[0][pin]->read(readDone0);
+    }
+}
+
+static void busyBusSetup(bool active)
+{
+    GPIOExpanderSimulator* simulator = GPIOExpanderSimulator::find(LOCATION_0);
+    simulator->setLatency(active ? BUSY_LATENCY : 0);
+    simulator->setBusyInterval(active ? BUSY_INTERVAL : 0);
+}
+#endif
+
+#if (LOCATION_COUNT > 1)
+/* Writes on one location interleaved with reads on the other. */
+static void mixedTraffic(void)
+{
+    for (uint8_t pin = 0; pin < PIN_COUNT; pin++)
+    {
+        issued(0);
+        outputs[0][pin]->write(iteration & 0x01, writeDone0);
+
+        issued(1);
+        inputs[1][pin]->read(readDone1);
+
+        issued(1);
+        outputs[1][pin]->write(iteration & 0x01, writeDone1);
+
+        issued(0);
+        inputs[0][pin]->read(readDone0);
+    }
+}
+#endif
+
+typedef struct {
+    const char* name;
+    void (*function)(void);
+    void (*setup)(bool active);     // optional, called before and after the workload
+} workload_t;
+
+static const workload_t workloads[] = {
+    { "burst write", burstWrite, NULL },
+    { "polling read", pollingRead, NULL },
+#if YOTTA_CFG_WRD_GPIO_SWITCH_SIMULATOR
+    { "interrupt storm", interruptStorm, NULL },
+    { "busy bus", busyBus, busyBusSetup },
+#endif
+#if (LOCATION_COUNT > 1)
+    { "mixed locations", mixedTraffic, NULL },
+#endif
+};
+
+static uint8_t workload;
+
+/*****************************************************************************/
+/* Runner                                                                    */
+/*****************************************************************************/
+
+static void startWorkload(void)
+{
+    if (workload < (sizeof(workloads) / sizeof(workload_t)))
+    {
+        iterationFunction = workloads[workload].function;
+        iteration = 0;
+        latencyCount = 0;
+        outstandingPeak = 0;
+        heapPeak = 0;
+
+#if YOTTA_CFG_WRD_GPIO_SWITCH_STATISTICS
+        for (uint8_t location = 0; location < LOCATION_COUNT; location++)
+        {
+            GPIOSwitch::resetStatistics(locations[location]);
+        }
+#endif
+
+        if (workloads[workload].setup)
+        {
+            workloads[workload].setup(true);
+        }
+
+        benchmarkStart = timer.read_us();
+        iterationFunction();
+    }
+    else
+    {
+        printf("benchmark done\r\n");
+    }
+}
+
+static void report(void)
+{
+    uint32_t elapsed = timer.read_us() - benchmarkStart;
+    uint32_t opsPerSecond = (elapsed) ? (uint64_t) latencyCount * 1000000 / elapsed : 0;
+
+    std::sort(latencies, latencies + latencyCount);
+
+    uint32_t p50 = latencies[(latencyCount * 50) / 100];
+    uint32_t p99 = latencies[(latencyCount * 99) / 100];
+
+    printf("%-16s ops: %5u ops/s: %7lu p50: %6lu us p99: %6lu us pending: %3lu",
+           workloads[workload].name,
+           latencyCount,
+           (unsigned long) opsPerSecond,
+           (unsigned long) p50,
+           (unsigned long) p99,
+           (unsigned long) outstandingPeak);
+
+#if YOTTA_CFG_WRD_GPIO_SWITCH_STATISTICS
+    // deepest command queue on any location
+    uint16_t depthMax = 0;
+
+    for (uint8_t location = 0; location < LOCATION_COUNT; location++)
+    {
+        GPIOSwitch::statistics_t statistics;
+
+        if (GPIOSwitch::getStatistics(locations[location], statistics))
+        {
+            depthMax = std::max(depthMax, statistics.queueDepthMax);
+        }
+    }
+
+    printf(" depth: %3u", depthMax);
+#endif
+
+    printf(" heap: %6lu\r\n", (unsigned long) heapPeak);
+}
+
+static void iterationDone(void)
+{
+    iteration++;
+
+    if (iteration < ITERATIONS)
+    {
+        iterationFunction();
+    }
+    else
+    {
+        report();
+
+        if (workloads[workload].setup)
+        {
+            workloads[workload].setup(false);
+        }
+
+        workload++;
+        startWorkload();
+    }
+}
+
+/*****************************************************************************/
+/* App start                                                                 */
+/*****************************************************************************/
+
+void app_start(int, char *[])
+{
+    for (uint8_t location = 0; location < LOCATION_COUNT; location++)
+    {
+        for (uint8_t pin = 0; pin < PIN_COUNT; pin++)
+        {
+            outputs[location][pin] = new DigitalOutEx(pin, locations[location]);
+            inputs[location][pin] = new DigitalInEx(pin + PIN_COUNT, locations[location]);
+        }
+    }
+
+#if YOTTA_CFG_WRD_GPIO_SWITCH_SIMULATOR
+    for (uint8_t pin = 0; pin < PIN_COUNT; pin++)
+    {
+        interrupts[pin] = new InterruptInEx(pin + PIN_COUNT, LOCATION_0);
+        interrupts[pin]->rise(interruptDone);
+        interrupts[pin]->fall(interruptDone);
+    }
+#else
+    (void) interrupts;
+#endif
+
+    timer.start();
+
+    // let pin configuration finish before measuring
+    minar::Scheduler::postCallback(startWorkload)
+        .delay(minar::milliseconds(100));
+}
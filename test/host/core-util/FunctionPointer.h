@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef __HOST_FUNCTION_POINTER_H__
+#define __HOST_FUNCTION_POINTER_H__
+
+/*
+    Host stand-in for core-util/FunctionPointer.h. Only the subset used by
+    wrd-gpio-switch is provided: construction from functions and member
+    functions, call, bind and the bool conversion.
+*/
+
+#include <functional>
+
+namespace mbed {
+namespace util {
+
+template <typename R>
+class FunctionPointerBind
+{
+public:
+    FunctionPointerBind()
+    {}
+
+    FunctionPointerBind(const std::function<R(void)>& _function)
+        :   function(_function)
+    {}
+
+    R call(void) const
+    {
+        return function();
+    }
+
+    R operator()(void) const
+    {
+        return function();
+    }
+
+    operator bool(void) const
+    {
+        return (bool) function;
+    }
+
+private:
+    std::function<R(void)> function;
+};
+
+template <typename R>
+class FunctionPointer0
+{
+public:
+    FunctionPointer0(R (*_function)(void) = 0)
+    {
+        if (_function)
+        {
+            function = _function;
+        }
+    }
+
+    template <typename T>
+    FunctionPointer0(T* object, R (T::*member)(void))
+        :   function(std::bind(member, object))
+    {}
+
+    R call(void) const
+    {
+        return function();
+    }
+
+    R operator()(void) const
+    {
+        return function();
+    }
+
+    operator bool(void) const
+    {
+        return (bool) function;
+    }
+
+    FunctionPointerBind<R> bind(void) const
+    {
+        return FunctionPointerBind<R>(function);
+    }
+
+    void clear(void)
+    {
+        function = nullptr;
+    }
+
+private:
+    std::function<R(void)> function;
+};
+
+template <typename R, typename A1>
+class FunctionPointer1
+{
+public:
+    FunctionPointer1(R (*_function)(A1) = 0)
+    {
+        if (_function)
+        {
+            function = _function;
+        }
+    }
+
+    template <typename T>
+    FunctionPointer1(T* object, R (T::*member)(A1))
+        :   function([object, member](A1 a1) { return (object->*member)(a1); })
+    {}
+
+    R call(A1 a1) const
+    {
+        return function(a1);
+    }
+
+    R operator()(A1 a1) const
+    {
+        return function(a1);
+    }
+
+    operator bool(void) const
+    {
+        return (bool) function;
+    }
+
+    FunctionPointerBind<R> bind(const A1& a1) const
+    {
+        std::function<R(A1)> copy = function;
+        return FunctionPointerBind<R>([copy, a1]() { return copy(a1); });
+    }
+
+    void clear(void)
+    {
+        function = nullptr;
+    }
+
+private:
+    std::function<R(A1)> function;
+};
+
+template <typename R, typename A1, typename A2, typename A3>
+class FunctionPointer3
+{
+public:
+    FunctionPointer3(R (*_function)(A1, A2, A3) = 0)
+    {
+        if (_function)
+        {
+            function = _function;
+        }
+    }
+
+    template <typename T>
+    FunctionPointer3(T* object, R (T::*member)(A1, A2, A3))
+        :   function([object, member](A1 a1, A2 a2, A3 a3) { return (object->*member)(a1, a2, a3); })
+    {}
+
+    R call(A1 a1, A2 a2, A3 a3) const
+    {
+        return function(a1, a2, a3);
+    }
+
+    R operator()(A1 a1, A2 a2, A3 a3) const
+    {
+        return function(a1, a2, a3);
+    }
+
+    operator bool(void) const
+    {
+        return (bool) function;
+    }
+
+    FunctionPointerBind<R> bind(const A1& a1, const A2& a2, const A3& a3) const
+    {
+        std::function<R(A1, A2, A3)> copy = function;
+        return FunctionPointerBind<R>([copy, a1, a2, a3]() { return copy(a1, a2, a3); });
+    }
+
+    void clear(void)
+    {
+        function = nullptr;
+    }
+
+private:
+    std::function<R(A1, A2, A3)> function;
+};
+
+} // namespace util
+} // namespace mbed
+
+#endif // __HOST_FUNCTION_POINTER_H__
@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "minar/minar.h"
+
+/* Entry point of the benchmark and unit test applications. */
+extern void app_start(int argc, char* argv[]);
+
+int main(int argc, char* argv[])
+{
+    app_start(argc, argv);
+
+    minar::Scheduler::start();
+
+    return 0;
+}
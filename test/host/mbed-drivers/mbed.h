@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef __HOST_MBED_H__
+#define __HOST_MBED_H__
+
+/*
+    Host stand-in for mbed-drivers/mbed.h. Pins on the main MCU are plain
+    memory, which is enough for the expander code paths that are measured.
+*/
+
+#include <chrono>
+#include <new>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "core-util/FunctionPointer.h"
+#include "minar/minar.h"
+
+#define MBED_OPERATORS 1
+
+typedef enum {
+    P0_0 = 0,
+    P0_1,
+    P0_2,
+    P0_3,
+    NC = (int) 0xFFFFFFFF
+} PinName;
+
+typedef enum {
+    PullUp,
+    PullDown,
+    PullNone,
+    OpenDrain
+} PinMode;
+
+typedef struct {
+    PinName pin;
+    int value;
+} gpio_t;
+
+inline void gpio_init_in(gpio_t* obj, PinName pin)
+{
+    obj->pin = pin;
+    obj->value = 0;
+}
+
+inline void gpio_init_in_ex(gpio_t* obj, PinName pin, PinMode)
+{
+    gpio_init_in(obj, pin);
+}
+
+inline void gpio_init_out(gpio_t* obj, PinName pin)
+{
+    gpio_init_in(obj, pin);
+}
+
+inline void gpio_init_out_ex(gpio_t* obj, PinName pin, int value)
+{
+    obj->pin = pin;
+    obj->value = value;
+}
+
+inline void gpio_write(gpio_t* obj, int value)
+{
+    obj->value = value;
+}
+
+inline int gpio_read(gpio_t* obj)
+{
+    return obj->value;
+}
+
+inline void gpio_mode(gpio_t*, PinMode)
+{}
+
+namespace mbed {
+
+class DigitalIn
+{
+public:
+    DigitalIn(PinName pin)
+    {
+        gpio_init_in(&gpio, pin);
+    }
+
+    DigitalIn(PinName pin, PinMode mode)
+    {
+        gpio_init_in_ex(&gpio, pin, mode);
+    }
+
+    int read(void)
+    {
+        return gpio_read(&gpio);
+    }
+
+    void mode(PinMode pull)
+    {
+        gpio_mode(&gpio, pull);
+    }
+
+private:
+    gpio_t gpio;
+};
+
+class DigitalOut
+{
+public:
+    DigitalOut(PinName pin)
+    {
+        gpio_init_out(&gpio, pin);
+    }
+
+    DigitalOut(PinName pin, int value)
+    {
+        gpio_init_out_ex(&gpio, pin, value);
+    }
+
+    int read(void)
+    {
+        return gpio_read(&gpio);
+    }
+
+    void write(int value)
+    {
+        gpio_write(&gpio, value);
+    }
+
+private:
+    gpio_t gpio;
+};
+
+/* Host pins never change on their own, so no edges are generated. */
+class InterruptIn
+{
+public:
+    InterruptIn(PinName pin)
+    {
+        gpio_init_in(&gpio, pin);
+    }
+
+    int read(void)
+    {
+        return gpio_read(&gpio);
+    }
+
+    void mode(PinMode pull)
+    {
+        gpio_mode(&gpio, pull);
+    }
+
+    void rise(void (*)(void))
+    {}
+
+    template <typename T>
+    void rise(T*, void (T::*)(void))
+    {}
+
+    void fall(void (*)(void))
+    {}
+
+    template <typename T>
+    void fall(T*, void (T::*)(void))
+    {}
+
+    void enable_irq(void)
+    {}
+
+    void disable_irq(void)
+    {}
+
+private:
+    gpio_t gpio;
+};
+
+class Timer
+{
+public:
+    Timer()
+        :   running(false),
+            elapsed(0)
+    {}
+
+    void start(void)
+    {
+        if (running == false)
+        {
+            begin = std::chrono::steady_clock::now();
+            running = true;
+        }
+    }
+
+    void stop(void)
+    {
+        elapsed = read_us();
+        running = false;
+    }
+
+    void reset(void)
+    {
+        begin = std::chrono::steady_clock::now();
+        elapsed = 0;
+    }
+
+    int read_us(void)
+    {
+        int result = elapsed;
+
+        if (running)
+        {
+            result += std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - begin).count();
+        }
+
+        return result;
+    }
+
+    int read_ms(void)
+    {
+        return read_us() / 1000;
+    }
+
+private:
+    std::chrono::steady_clock::time_point begin;
+    bool running;
+    int elapsed;
+};
+
+} // namespace mbed
+
+using namespace mbed;
+
+#endif // __HOST_MBED_H__
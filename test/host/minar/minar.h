@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef __HOST_MINAR_H__
+#define __HOST_MINAR_H__
+
+/*
+    Host stand-in for the MINAR scheduler. Callbacks run in due order from
+    Scheduler::start, which returns once no callbacks are left.
+*/
+
+#include "core-util/FunctionPointer.h"
+
+#include <chrono>
+#include <functional>
+#include <list>
+#include <thread>
+#include <stdint.h>
+
+namespace minar {
+
+typedef uint32_t tick_t;
+typedef void* callback_handle_t;
+
+inline tick_t milliseconds(uint32_t ms)
+{
+    return ms;
+}
+
+class Scheduler
+{
+public:
+    struct Event
+    {
+        std::function<void(void)> function;
+        tick_t posted;
+        tick_t due;
+        tick_t interval;
+        bool running;
+        bool cancelled;
+    };
+
+    class CallbackAdder
+    {
+    public:
+        CallbackAdder(Event* _event)
+            :   event(_event)
+        {}
+
+        CallbackAdder& delay(tick_t ticks)
+        {
+            event->due = event->posted + ticks;
+            return *this;
+        }
+
+        CallbackAdder& tolerance(tick_t)
+        {
+            return *this;
+        }
+
+        CallbackAdder& period(tick_t ticks)
+        {
+            event->interval = ticks;
+            return *this;
+        }
+
+        callback_handle_t getHandle(void)
+        {
+            return event;
+        }
+
+    private:
+        Event* event;
+    };
+
+    template <typename F>
+    static CallbackAdder postCallback(const F& function)
+    {
+        tick_t now = getTime();
+
+        events().push_back(Event{ function, now, now, 0, false, false });
+
+        return CallbackAdder(&events().back());
+    }
+
+    static int cancelCallback(callback_handle_t handle)
+    {
+        for (std::list<Event>::iterator it = events().begin(); it != events().end(); ++it)
+        {
+            if (&(*it) == handle)
+            {
+                it->cancelled = true;
+
+                if (it->running == false)
+                {
+                    events().erase(it);
+                }
+
+                return 1;
+            }
+        }
+
+        return 0;
+    }
+
+    static tick_t getTime(void)
+    {
+        static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - epoch).count();
+    }
+
+    /* Run callbacks until none are left. */
+    static void start(void);
+
+private:
+    static std::list<Event>& events(void)
+    {
+        static std::list<Event> list;
+        return list;
+    }
+};
+
+inline void Scheduler::start(void)
+{
+    while (events().empty() == false)
+    {
+        // earliest due callback, in posting order for equal due times
+        std::list<Event>::iterator next = events().begin();
+
+        for (std::list<Event>::iterator it = next; it != events().end(); ++it)
+        {
+            if ((int32_t)(it->due - next->due) < 0)
+            {
+                next = it;
+            }
+        }
+
+        while ((int32_t)(next->due - getTime()) > 0)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+
+        next->running = true;
+        next->function();
+        next->running = false;
+
+        if ((next->interval > 0) && (next->cancelled == false))
+        {
+            next->due += next->interval;
+        }
+        else
+        {
+            events().erase(next);
+        }
+    }
+}
+
+} // namespace minar
+
+#endif // __HOST_MINAR_H__
@@ -0,0 +1,356 @@
+/*
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*
+ * GPIOSwitch queue checks for the host build.
+ *
+ * Runs the command queue against the simulated expander and checks when
+ * callbacks are called and which values reach the device. Each queue case
+ * keeps the bus busy with a read, so commands queue up behind it. The
+ * remaining cases check that interrupt resources are released.
+ */
+
+#include "mbed-drivers/mbed.h"
+
+#include "wrd-gpio-switch/GPIOSwitch.h"
+#include "wrd-gpio-switch/InterruptInEx.h"
+#include "wrd-gpio-switch/GPIOExpanderSimulator.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define LOCATION_0      YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_GPIO0_I2C_ADDRESS
+#define LATENCY         2
+#define CASE_TIME       20
+
+/* second expander without interrupt pin, see Makefile */
+#define LOCATION_1      YOTTA_CFG_HARDWARE_WRD_GPIO_EXPANDER_GPIO1_I2C_ADDRESS
+#define SCAN_TIME       200
+#define TRACK_TIME      200
+
+static GPIOExpanderSimulator* simulator;
+static uint8_t failures;
+
+/* callback names and the device pin value each one saw */
+static char order[8];
+static int seen[8];
+static uint8_t orderLength;
+
+static void check(bool condition, const char* name)
+{
+    printf("%-48s %s\r\n", name, (condition) ? "ok" : "FAILED");
+
+    if (condition == false)
+    {
+        failures++;
+    }
+}
+
+static void record(char name, uint8_t pin)
+{
+    if (orderLength < sizeof(order) - 1)
+    {
+        order[orderLength] = name;
+        seen[orderLength] = (simulator->getPins() >> pin) & 0x01;
+        orderLength++;
+    }
+}
+
+static void busy(void)
+{
+    GPIOSwitch::readInput(8, LOCATION_0, (void (*)(int)) NULL);
+}
+
+/*****************************************************************************/
+/* High priority write matching an unsent normal priority write              */
+/*****************************************************************************/
+
+static void matchA(void)
+{
+    record('a', 0);
+}
+
+static void matchB(void)
+{
+    record('b', 0);
+}
+
+static void matchStart(void)
+{
+    busy();
+    GPIOSwitch::writeOutput(0, LOCATION_0, 1, matchA);
+    GPIOSwitch::writeOutput(0, LOCATION_0, 1, matchB, GPIOSwitch::PRIORITY_HIGH);
+}
+
+static void matchCheck(void)
+{
+    check((orderLength == 2) && (seen[0] == 1) && (seen[1] == 1),
+          "callbacks run after the pin has been set");
+}
+
+/*****************************************************************************/
+/* High priority write overtaking a normal priority write to the same pin    */
+/*****************************************************************************/
+
+static void overtakeStart(void)
+{
+    busy();
+    GPIOSwitch::writeOutput(1, LOCATION_0, 0, (void (*)(void)) NULL);
+    GPIOSwitch::writeOutput(1, LOCATION_0, 1, (void (*)(void)) NULL, GPIOSwitch::PRIORITY_HIGH);
+}
+
+static void overtakeCheck(void)
+{
+    check((((simulator->getPins() >> 1) & 0x01) == 1) &&
+          (GPIOSwitch::readOutput(1, LOCATION_0) == 1),
+          "newest write wins across priorities");
+}
+
+/*****************************************************************************/
+/* Writes that change nothing                                                */
+/*****************************************************************************/
+
+static void elidedA(void)
+{
+    record('a', 2);
+}
+
+static void elidedB(void)
+{
+    record('b', 3);
+}
+
+static void elidedC(void)
+{
+    record('c', 3);
+}
+
+static uint32_t elidedCommands;
+
+static void elidedStart(void)
+{
+    elidedCommands = simulator->getCommandCount();
+
+    busy();
+    GPIOSwitch::writeOutput(2, LOCATION_0, 1, elidedA);
+    GPIOSwitch::writeOutput(3, LOCATION_0, 0, elidedB);
+    GPIOSwitch::writeOutput(3, LOCATION_0, 0, elidedC);
+}
+
+static void elidedCheck(void)
+{
+    check((orderLength == 3) && (strncmp(order, "abc", 3) == 0),
+          "callbacks of elided writes keep their order");
+
+    // only the read and one write reach the device
+    check((simulator->getCommandCount() - elidedCommands) == 2,
+          "writes that change nothing are not sent");
+}
+
+/*****************************************************************************/
+/* Debounce slots released with the pin                                      */
+/*****************************************************************************/
+
+static void debounceEdge(void)
+{
+}
+
+static bool debounceReleased;
+
+/* more pins than debounce slots, one pin at a time */
+static void debounceStart(void)
+{
+    debounceReleased = true;
+
+    for (uint8_t round = 0; round < 32; round++)
+    {
+        InterruptInEx* button = new InterruptInEx(round, LOCATION_0);
+
+        if ((round % 4) == 0)
+        {
+            // no callback, only the destructor frees the slot
+            debounceReleased &= button->setDebounce(GPIOSwitch::DEBOUNCE_WINDOW, 10);
+        }
+        else
+        {
+            button->rise(debounceEdge);
+            debounceReleased &= button->setDebounce(GPIOSwitch::DEBOUNCE_INTEGRATOR, 10);
+
+            if (round % 2)
+            {
+                button->disable_irq();
+            }
+        }
+
+        delete button;
+    }
+}
+
+static void debounceCheck(void)
+{
+    check(debounceReleased, "debounce slots are released with the pin");
+}
+
+/*****************************************************************************/
+/* Tracked inputs                                                            */
+/*****************************************************************************/
+
+static bool trackFullResult;
+static uint32_t trackDropped;
+
+static uint32_t droppedInterrupts(void)
+{
+    GPIOSwitch::statistics_t statistics;
+    GPIOSwitch::getStatistics(LOCATION_0, statistics);
+
+    return statistics.interruptsDropped;
+}
+
+static void trackChange(void)
+{
+    simulator->setInput(0x0400, 0x0400);
+}
+
+static void trackStart(void)
+{
+    trackDropped = droppedInterrupts();
+
+    GPIOSwitch::trackInput(10, LOCATION_0);
+
+    // fill the queue, so the seeding read for pin 11 does not fit
+    for (uint8_t count = 0; count < 32; count++)
+    {
+        busy();
+    }
+
+    trackFullResult = GPIOSwitch::trackInput(11, LOCATION_0);
+
+    minar::Scheduler::postCallback(trackChange)
+        .delay(minar::milliseconds(TRACK_TIME / 2));
+}
+
+static void trackCheck(void)
+{
+    check((GPIOSwitch::readInputCached(10, LOCATION_0) == 1) &&
+          (droppedInterrupts() == trackDropped),
+          "tracked changes are not counted as dropped");
+
+    check((trackFullResult == false) &&
+          ((simulator->getInterruptMask() & 0x0800) == 0),
+          "failed tracking leaves the interrupt disabled");
+}
+
+/*****************************************************************************/
+/* Changes on an expander without interrupt pin                              */
+/*****************************************************************************/
+
+static uint8_t scanEdges;
+
+static void scanEdge(int)
+{
+    scanEdges++;
+}
+
+static void scanChange(void)
+{
+    GPIOExpanderSimulator::find(LOCATION_1)->setInput(0x0100, 0x0100);
+}
+
+static void scanStart(void)
+{
+    scanEdges = 0;
+
+    GPIOSwitch::enableInterrupt(8, LOCATION_1, scanEdge);
+
+    // after the first scan has recorded the pin
+    minar::Scheduler::postCallback(scanChange)
+        .delay(minar::milliseconds(SCAN_TIME / 2));
+}
+
+static void scanCheck(void)
+{
+    GPIOSwitch::disableInterrupt(8, LOCATION_1);
+
+    check(scanEdges == 1, "scanned change is reported once");
+}
+
+/*****************************************************************************/
+/* Runner                                                                    */
+/*****************************************************************************/
+
+typedef struct {
+    void (*start)(void);
+    void (*check)(void);
+    uint32_t time;
+} case_t;
+
+static const case_t cases[] = {
+    { matchStart, matchCheck, CASE_TIME },
+    { overtakeStart, overtakeCheck, CASE_TIME },
+    { elidedStart, elidedCheck, CASE_TIME },
+    { debounceStart, debounceCheck, CASE_TIME },
+    { trackStart, trackCheck, TRACK_TIME },
+    { scanStart, scanCheck, SCAN_TIME },
+};
+
+static uint8_t current;
+
+static void runCase(void);
+
+static void checkCase(void)
+{
+    cases[current].check();
+
+    current++;
+    runCase();
+}
+
+static void runCase(void)
+{
+    if (current < (sizeof(cases) / sizeof(case_t)))
+    {
+        memset(order, 0, sizeof(order));
+        orderLength = 0;
+
+        cases[current].start();
+
+        minar::Scheduler::postCallback(checkCase)
+            .delay(minar::milliseconds(cases[current].time));
+    }
+    else
+    {
+        printf("queue checks %s\r\n", (failures) ? "FAILED" : "passed");
+
+        exit((failures) ? EXIT_FAILURE : EXIT_SUCCESS);
+    }
+}
+
+void app_start(int, char *[])
+{
+    simulator = GPIOExpanderSimulator::find(LOCATION_0);
+    simulator->setLatency(LATENCY);
+
+    for (uint8_t pin = 0; pin < 4; pin++)
+    {
+        GPIOSwitch::configureOutput(pin, LOCATION_0, (pin == 1) ? 1 : 0);
+    }
+
+    // let pin configuration finish
+    minar::Scheduler::postCallback(runCase)
+        .delay(minar::milliseconds(CASE_TIME));
+}
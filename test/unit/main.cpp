@@ -62,10 +62,12 @@ static void toggleLed1()
 void app_start(int, char *[])
 {
 #ifdef BUTTON_0_ENABLED
+    button0.setDebounce(GPIOSwitch::DEBOUNCE_WINDOW, 20);
     button0.fall(toggleLed0);
 #endif
 
 #ifdef BUTTON_1_ENABLED
+    button1.setDebounce(GPIOSwitch::DEBOUNCE_WINDOW, 20);
     button1.fall(toggleLed1);
 #endif
 }
@@ -19,7 +19,7 @@
 #define __WRD_GPIO_DIGITAL_IN_EX_H__
 
 #include "mbed-drivers/mbed.h"
-#include "core-util/SharedPointer.h"
+#include "wrd-gpio-switch/GPIOSwitch.h"
 
 using namespace mbed::util;
 
@@ -50,6 +50,16 @@ public:
      */
     DigitalInEx(uint32_t pin, uint32_t location, PinMode mode);
 
+    /**
+     * @brief Copy a DigitalInEx, including the pin on the main MCU.
+     */
+    DigitalInEx(const DigitalInEx& other);
+
+    /**
+     * @brief Release the pin.
+     */
+    ~DigitalInEx();
+
     /**
      * @brief Read the input, represented as 0 or 1 (int)
      * @details For inputs on external I/O devices, a cached value is returned
@@ -67,9 +77,34 @@ public:
      *          This function call reads the newest value from external I/O
      *          devices.
      *
-     * @param callback [description]
+     * @param callback Function to call with the pin value.
+     * @param priority Queue priority for commands to external I/O devices.
      */
-    void read(FunctionPointer1<void, int> callback);
+    void read(FunctionPointer1<void, int> callback,
+              GPIOSwitch::priority_t priority = GPIOSwitch::PRIORITY_NORMAL);
+
+    /**
+     * @brief Keep the input value up to date through interrupts.
+     * @details For inputs on external I/O devices with an interrupt pin,
+     *          the value is updated whenever the pin changes, and read()
+     *          returns the current value without any bus traffic. On devices
+     *          without an interrupt pin, the value is updated by the periodic
+     *          scan in GPIOSwitch.
+     *
+     * @return bool true the value is tracked through interrupts,
+     *         false read() polls the device.
+     */
+    bool track(void);
+
+    /**
+     * @brief Skip bus reads when the input shadow is recent enough.
+     * @details read() returns the value from the location's input shadow
+     *          without scheduling a read if it is at most maxAge milliseconds
+     *          old. The default is set by wrd-gpio-switch.input-max-age.
+     *
+     * @param maxAge Maximum age in milliseconds, 0 to always read.
+     */
+    void setMaxAge(uint32_t maxAge);
 
     /**
      * @brief Set the input pin mode.
@@ -90,13 +125,33 @@ public:
 #endif
 
 private:
+    /* assigning would have to rebuild the pin on the main MCU, use the
+       copy constructor instead.
+    */
+    DigitalInEx& operator=(const DigitalInEx&);
+
     void updateCache(int);
 
     uint32_t pin;
     uint32_t location;
     int cache;
+    bool tracked;
+    uint32_t maxAge;
+
+    /* DigitalIn for pins on the main MCU, constructed in place so no heap
+       allocation is needed.
+    */
+    alignas(DigitalIn) uint8_t localStorage[sizeof(DigitalIn)];
 
-    SharedPointer<DigitalIn> local;
+    DigitalIn* local(void)
+    {
+        return reinterpret_cast<DigitalIn*>(localStorage);
+    }
+
+    const DigitalIn* local(void) const
+    {
+        return reinterpret_cast<const DigitalIn*>(localStorage);
+    }
 };
 
 #endif // __WRD_GPIO_DIGITAL_IN_EX_H__
@@ -19,7 +19,7 @@
 #define __WRD_GPIO_DIGITAL_OUT_EX_H__
 
 #include "mbed-drivers/mbed.h"
-#include "core-util/SharedPointer.h"
+#include "wrd-gpio-switch/GPIOSwitch.h"
 
 using namespace mbed::util;
 
@@ -51,6 +51,16 @@ public:
      */
     DigitalOutEx(uint32_t pin, int value, uint32_t location);
 
+    /**
+     * @brief Copy a DigitalOutEx, including the pin on the main MCU.
+     */
+    DigitalOutEx(const DigitalOutEx& other);
+
+    /**
+     * @brief Release the pin.
+     */
+    ~DigitalOutEx();
+
     /**
      * @brief Return the output setting, represented as 0 or 1 (int).
      * @return An integer representing the output setting of the pin,
@@ -75,8 +85,10 @@ public:
      * @param value An integer specifying the pin output value, 0 for logical 0,
      *              1 (or any other non-zero value) for logical 1.
      * @param callback The function to call once the new value has been applied.
+     * @param priority Queue priority for commands to external I/O devices.
      */
-    void write(int value, FunctionPointer0<void> callback);
+    void write(int value, FunctionPointer0<void> callback,
+               GPIOSwitch::priority_t priority = GPIOSwitch::PRIORITY_NORMAL);
 
     /**
      * @brief Set the output, specified as 0 or 1 (int).
@@ -127,9 +139,28 @@ public:
 #endif
 
 private:
+    /* assigning from a DigitalOutEx writes its value, see operator= above.
+       Copying the pin itself is only supported by the copy constructor.
+    */
+    DigitalOutEx& operator=(const DigitalOutEx&);
+
     uint32_t pin;
     uint32_t location;
-    SharedPointer<DigitalOut> local;
+
+    /* DigitalOut for pins on the main MCU, constructed in place so no heap
+       allocation is needed.
+    */
+    alignas(DigitalOut) uint8_t localStorage[sizeof(DigitalOut)];
+
+    DigitalOut* local(void)
+    {
+        return reinterpret_cast<DigitalOut*>(localStorage);
+    }
+
+    const DigitalOut* local(void) const
+    {
+        return reinterpret_cast<const DigitalOut*>(localStorage);
+    }
 };
 
 #endif // __WRD_GPIO_DIGITAL_OUT_EX_H__
@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __WRD_GPIO_EXPANDER_SIMULATOR_H__
+#define __WRD_GPIO_EXPANDER_SIMULATOR_H__
+
+#include "mbed-drivers/mbed.h"
+
+using namespace mbed::util;
+
+/**
+ * @brief Simulated I/O expander with the same interface as GPIOExpander.
+ * @details Used in place of GPIOExpander when the wrd-gpio-switch.simulator
+ *          config is set, so GPIOSwitch can be exercised and measured without
+ *          I/O expander hardware. Commands complete through MINAR after a
+ *          configurable latency. The device can be made to report busy or to
+ *          drop commands, and input changes on interrupt enabled pins call
+ *          the interrupt handler, unless the interrupt pin is NC.
+ */
+class GPIOExpanderSimulator
+{
+public:
+    /**
+     * @brief Create simulated I/O expander.
+     * @details The I2C pins are ignored and only kept for compatibility
+     *          with GPIOExpander. Without an interrupt pin, input changes
+     *          are only seen by reading, like on the real device.
+     *
+     * @param sda I2C data pin.
+     * @param scl I2C clock pin.
+     * @param address I2C address, used as location.
+     * @param irq Interrupt pin, NC if not connected.
+     */
+    GPIOExpanderSimulator(PinName sda, PinName scl, uint16_t address, PinName irq);
+
+    /**
+     * @brief Set direction for pins in mask. 0 is input, 1 is output.
+     * @return bool true command accepted, false device busy.
+     */
+    bool bulkSetDirection(uint32_t mask, uint32_t direction, FunctionPointer0<void> callback);
+
+    /**
+     * @brief Set output value for pins in mask.
+     * @return bool true command accepted, false device busy.
+     */
+    bool bulkWrite(uint32_t mask, uint32_t values, FunctionPointer0<void> callback);
+
+    /**
+     * @brief Read all pins. Output pins return the output value.
+     * @return bool true command accepted, false device busy.
+     */
+    bool bulkRead(FunctionPointer1<void, uint32_t> callback);
+
+    /**
+     * @brief Enable or disable interrupts for pins in mask.
+     * @return bool true command accepted, false device busy.
+     */
+    bool bulkSetInterrupt(uint32_t mask, uint32_t enable, FunctionPointer0<void> callback);
+
+    /**
+     * @brief Set function to call with address, changed pins and pin values
+     *        when interrupt enabled inputs change.
+     */
+    void setInterruptHandler(FunctionPointer3<void, uint16_t, uint32_t, uint32_t> handler);
+
+    /**
+     * @brief Set time from a command being accepted until it completes.
+     *
+     * @param milliseconds Command latency. 0 completes on the next dispatch.
+     */
+    void setLatency(uint32_t milliseconds);
+
+    /**
+     * @brief Report every n-th command as busy.
+     *
+     * @param interval n. 0 disables busy injection.
+     */
+    void setBusyInterval(uint32_t interval);
+
+    /**
+     * @brief Drop every n-th accepted command, as if it was not acknowledged.
+     * @details The command completes normally, but has no effect. Reads
+     *          return 0.
+     *
+     * @param interval n. 0 disables NACK injection.
+     */
+    void setNackInterval(uint32_t interval);
+
+    /**
+     * @brief Drive input pins.
+     * @details Changes on interrupt enabled input pins call the interrupt
+     *          handler after the configured latency, if the simulator has
+     *          an interrupt pin.
+     *
+     * @param mask Pins to change.
+     * @param values New pin values.
+     */
+    void setInput(uint32_t mask, uint32_t values);
+
+    /**
+     * @brief Current level of all pins, as returned by bulkRead.
+     */
+    uint32_t getPins(void) const;
+
+    /**
+     * @brief Direction of all pins. 0 is input, 1 is output.
+     */
+    uint32_t getDirection(void) const;
+
+    /**
+     * @brief Pins with interrupts enabled.
+     */
+    uint32_t getInterruptMask(void) const;
+
+    /**
+     * @brief Number of commands accepted since creation.
+     */
+    uint32_t getCommandCount(void) const;
+
+    /**
+     * @brief Find simulated I/O expander by address.
+     *
+     * @param address I2C address.
+     * @return Simulator, NULL if no simulator has that address.
+     */
+    static GPIOExpanderSimulator* find(uint16_t address);
+
+private:
+    typedef enum {
+        COMMAND_NONE,
+        COMMAND_DIRECTION,
+        COMMAND_WRITE,
+        COMMAND_READ,
+        COMMAND_INTERRUPT
+    } command_t;
+
+    bool begin(command_t command, uint32_t mask, uint32_t value);
+    void complete(void);
+    void interrupt(void);
+
+    uint16_t address;
+    PinName irq;
+
+    uint32_t direction;
+    uint32_t outputs;
+    uint32_t inputs;
+    uint32_t interruptMask;
+
+    uint32_t latency;
+    uint32_t busyInterval;
+    uint32_t nackInterval;
+    uint32_t requestCount;
+    uint32_t commandCount;
+
+    command_t command;
+    uint32_t commandMask;
+    uint32_t commandValue;
+    FunctionPointer0<void> doneCallback;
+    FunctionPointer1<void, uint32_t> readCallback;
+
+    uint32_t interruptPins;
+    FunctionPointer3<void, uint16_t, uint32_t, uint32_t> interruptHandler;
+};
+
+#endif // __WRD_GPIO_EXPANDER_SIMULATOR_H__
@@ -24,17 +24,58 @@ using namespace mbed::util;
 
 namespace GPIOSwitch
 {
+    /**
+     * @brief Counters for one external I/O device.
+     * @details Only collected when the wrd-gpio-switch.statistics config is set.
+     */
+    typedef struct {
+        uint32_t reads;                 // bus transactions by action type
+        uint32_t writes;
+        uint32_t directions;
+        uint32_t interrupts;
+        uint32_t busyRetries;           // commands rejected because the device was busy
+        uint32_t timeInFlight;          // MINAR ticks spent waiting for the device
+        uint32_t interruptsDispatched;  // pin changes delivered to a callback
+        uint32_t interruptsDropped;     // pin changes not tracked and without a callback
+        uint16_t queueDepth;            // transactions currently queued
+        uint16_t queueDepthMax;         // highest queueDepth since reset
+    } statistics_t;
+
+    /**
+     * @brief Priority class for queued commands.
+     * @details High priority commands are sent before normal priority ones,
+     *          but a waiting normal priority command is never delayed by more
+     *          than wrd-gpio-switch.priority-burst high priority commands.
+     *          Ordering is only kept between commands of the same priority.
+     */
+    typedef enum {
+        PRIORITY_NORMAL,
+        PRIORITY_HIGH
+    } priority_t;
+
+    /**
+     * @brief Debounce modes for interrupt pins.
+     */
+    typedef enum {
+        DEBOUNCE_NONE,          // every edge is reported
+        DEBOUNCE_WINDOW,        // report first edge, then ignore edges for the debounce time
+        DEBOUNCE_INTEGRATOR     // report when the pin has been stable for about the debounce time
+    } debounce_t;
+
     /**
      * @brief Read pin value from external I/O device.
-     * @details All calls are processed through a FIFO queue.
+     * @details All calls are processed through a FIFO queue. Consecutive
+     *          reads from the same location are served by a single bus transaction.
      *
      * @param pin Zero indexed pin number.
      * @param location Address for external I/O device. For I2C devices,
      *                 the I2C address is the location.
      * @param callback Function to call with pin value as parameter.
-     * @return bool true command accepted by location, false location not found.
+     * @param priority Queue priority for the command.
+     * @return bool true command accepted by location, false location not found or queue full.
      */
-    bool readInput(uint8_t pin, uint16_t location, FunctionPointer1<void, int> callback);
+    bool readInput(uint8_t pin, uint16_t location, FunctionPointer1<void, int> callback,
+                   priority_t priority = PRIORITY_NORMAL);
 
     /**
      * @brief Read output value for a pin on an external I/O device.
@@ -49,39 +90,53 @@ namespace GPIOSwitch
 
     /**
      * @brief Set output pin value. This function is safe to call from interrupt context.
-     * @details Calls writeOutputTask through MINAR to decouple from interrupt context.
+     * @details In interrupt context, the command is placed in a lock-free ring
+     *          which is moved into the FIFO queue by a single MINAR callback.
+     *          The ring has a single producer, so only call this function from
+     *          interrupts of one priority level. Outside interrupt context,
+     *          this is the same as writeOutputTask.
      *
      * @param pin Zero indexed pin number.
      * @param location Address for external I/O device. For I2C devices,
      *                 the I2C address is the location.
      * @param value pin value. 0 is low, 1 is high.
+     * @return bool true command accepted by location, false location not found or ring full.
      */
-    void writeOutputIrq(uint8_t pin, uint16_t location, int8_t value);
+    bool writeOutputIrq(uint8_t pin, uint16_t location, int8_t value);
 
     /**
      * @brief Set output pin value.
-     * @details All calls are processed through a FIFO queue.
+     * @details All calls are processed through a FIFO queue. Consecutive
+     *          writes to the same location still waiting in the queue are
+     *          combined, so only the newest value per pin is sent.
      *
      * @param pin Zero indexed pin number.
      * @param location Address for external I/O device. For I2C devices,
      *                 the I2C address is the location.
      * @param value pin value. 0 is low, 1 is high.
+     * @param priority Queue priority for the command.
+     * @return bool true command accepted by location, false location not found or queue full.
      */
-    void writeOutputTask(uint8_t pin, uint16_t location, int8_t value);
+    bool writeOutputTask(uint8_t pin, uint16_t location, int8_t value,
+                         priority_t priority = PRIORITY_NORMAL);
 
     /**
      * @brief Set output pin value.
      * @details All calls are processed through a FIFO queue. A callback function
-     *          is called when the command has been processed.
+     *          is called when the command has been processed. Consecutive
+     *          writes to the same location still waiting in the queue are
+     *          combined, so only the newest value per pin is sent.
      *
      * @param pin Zero indexed pin number.
      * @param location Address for external I/O device. For I2C devices,
      *                 the I2C address is the location.
      * @param value pin value. 0 is low, 1 is high.
      * @param callback Function to be called when command has been processed.
-     * @return bool true command accepted by location, false location not found.
+     * @param priority Queue priority for the command.
+     * @return bool true command accepted by location, false location not found or queue full.
      */
-    bool writeOutput(uint8_t pin, uint16_t location, int8_t value, FunctionPointer0<void> callback);
+    bool writeOutput(uint8_t pin, uint16_t location, int8_t value, FunctionPointer0<void> callback,
+                     priority_t priority = PRIORITY_NORMAL);
 
     /**
      * @brief Set pin direction.
@@ -91,33 +146,274 @@ namespace GPIOSwitch
      * @param location Address for external I/O device. For I2C devices,
      *                 the I2C address is the location.
      * @param direction 0 is input, 1 is output.
+     * @param priority Queue priority for the command.
      *
-     * @return bool true command accepted by location, false location not found.
+     * @return bool true command accepted by location, false location not found or queue full.
+     */
+    bool setDirection(uint8_t pin, uint16_t location, int8_t direction,
+                      priority_t priority = PRIORITY_NORMAL);
+
+    /**
+     * @brief Configure pin as output with an initial value.
+     * @details Configuration is collected and sent from a single MINAR
+     *          callback, using one bus transaction per kind of setting for
+     *          each location. Any other command for the location sends the
+     *          pending configuration first, so ordering is kept.
+     *
+     * @param pin Zero indexed pin number.
+     * @param location Address for external I/O device. For I2C devices,
+     *                 the I2C address is the location.
+     * @param value Initial pin value. 0 is low, 1 is high.
+     * @return bool true configuration accepted, false location not found.
+     */
+    bool configureOutput(uint8_t pin, uint16_t location, int8_t value);
+
+    /**
+     * @brief Configure pin as input.
+     * @details Collected and sent the same way as configureOutput.
+     *
+     * @param pin Zero indexed pin number.
+     * @param location Address for external I/O device. For I2C devices,
+     *                 the I2C address is the location.
+     * @return bool true configuration accepted, false location not found.
+     */
+    bool configureInput(uint8_t pin, uint16_t location);
+
+    /**
+     * @brief Configure multiple pins as outputs with initial values.
+     * @details Collected and sent the same way as configureOutput.
+     *
+     * @param mask Bit mask selecting the pins to configure.
+     * @param value Initial pin values, one bit per pin. 0 is low, 1 is high.
+     * @param location Address for external I/O device. For I2C devices,
+     *                 the I2C address is the location.
+     * @return bool true configuration accepted, false location not found.
+     */
+    bool configurePortOutput(uint32_t mask, uint32_t value, uint16_t location);
+
+    /**
+     * @brief Configure multiple pins as inputs.
+     * @details Collected and sent the same way as configureOutput.
+     *
+     * @param mask Bit mask selecting the pins to configure.
+     * @param location Address for external I/O device. For I2C devices,
+     *                 the I2C address is the location.
+     * @return bool true configuration accepted, false location not found.
+     */
+    bool configurePortInput(uint32_t mask, uint16_t location);
+
+    /**
+     * @brief Read values for all pins on an external I/O device.
+     * @details All calls are processed through a FIFO queue. Consecutive
+     *          reads from the same location are served by a single bus transaction.
+     *
+     * @param location Address for external I/O device. For I2C devices,
+     *                 the I2C address is the location.
+     * @param callback Function to call with pin values, one bit per pin, as parameter.
+     * @param mask Bit mask applied to the pin values before calling callback.
+     * @param priority Queue priority for the command.
+     * @return bool true command accepted by location, false location not found or queue full.
+     */
+    bool readPort(uint16_t location, FunctionPointer1<void, uint32_t> callback, uint32_t mask = 0xFFFFFFFF,
+                  priority_t priority = PRIORITY_NORMAL);
+
+    /**
+     * @brief Read output values for all pins on an external I/O device.
+     * @details A cached value is returned and not read from the device for optimization.
+     *
+     * @param location Address for external I/O device. For I2C devices,
+     *                 the I2C address is the location.
+     * @return uint32_t pin values, one bit per pin. 0 if location not found.
+     */
+    uint32_t readOutputPort(uint16_t location);
+
+    /**
+     * @brief Set output values for multiple pins at once.
+     * @details All calls are processed through a FIFO queue. The pins selected
+     *          by the mask are updated in a single bus transaction. A callback
+     *          function is called when the command has been processed.
+     *
+     * @param mask Bit mask selecting the pins to update.
+     * @param value Pin values, one bit per pin. 0 is low, 1 is high.
+     * @param location Address for external I/O device. For I2C devices,
+     *                 the I2C address is the location.
+     * @param callback Function to be called when command has been processed.
+     * @param priority Queue priority for the command.
+     * @return bool true command accepted by location, false location not found or queue full.
+     */
+    bool writePort(uint32_t mask, uint32_t value, uint16_t location, FunctionPointer0<void> callback,
+                   priority_t priority = PRIORITY_NORMAL);
+
+    /**
+     * @brief Set direction for multiple pins at once.
+     * @details All calls are processed through a FIFO queue. The pins selected
+     *          by the mask are updated in a single bus transaction.
+     *
+     * @param mask Bit mask selecting the pins to update.
+     * @param direction Pin directions, one bit per pin. 0 is input, 1 is output.
+     * @param location Address for external I/O device. For I2C devices,
+     *                 the I2C address is the location.
+     * @param priority Queue priority for the command.
+     * @return bool true command accepted by location, false location not found or queue full.
      */
-    bool setDirection(uint8_t pin, uint16_t location, int8_t direction);
+    bool setPortDirection(uint32_t mask, uint32_t direction, uint16_t location,
+                          priority_t priority = PRIORITY_NORMAL);
 
     /**
      * @brief Enable interrupts on pin at location.
-     * @details This call sets the pin direction to input.
+     * @details This call sets the pin direction to input. The interrupt
+     *          setting is collected with other configuration, see
+     *          configureOutput. Expanders without an interrupt pin are
+     *          scanned every wrd-gpio-switch.scan-period milliseconds
+     *          instead, and changes are reported the same way.
      *
      * @param pin Zero indexed pin number.
      * @param location Address for external I/O device. For I2C devices,
      *                 the I2C address is the location.
      * @param callback Function to be called with pin value upon change.
-     * @return bool true command accepted by location, false location not found.
+     * @return bool true command accepted by location, false location not found or pin out of range.
      */
     bool enableInterrupt(uint8_t pin, uint16_t location, FunctionPointer1<void, int> callback);
 
     /**
      * @brief Disable interrupts on pin at location.
+     * @details Also stops tracking the pin and removes its debouncing.
      *
      * @param pin Zero indexed pin number.
      * @param location Address for external I/O device. For I2C devices,
      *                 the I2C address is the location.
      *
-     * @return bool true command accepted by location, false location not found.
+     * @return bool true command accepted by location, false location not found or pin out of range.
      */
     bool disableInterrupt(uint8_t pin, uint16_t location);
+
+    /**
+     * @brief Enable interrupts on multiple pins with a single callback.
+     * @details Puts the location in batched mode: pin changes from any number
+     *          of device interrupts are collected and delivered from a single
+     *          MINAR callback. The callback is called once with all changed
+     *          pins in mask, followed by the per-pin callbacks registered
+     *          with enableInterrupt, e.g. from InterruptInEx.
+     *          The pins are set to input. Each location has one port
+     *          callback: to add pins to it, pass an empty callback.
+     *
+     * @param mask Bit mask selecting the pins to enable.
+     * @param location Address for external I/O device. For I2C devices,
+     *                 the I2C address is the location.
+     * @param callback Function to be called with location, mask of changed
+     *                 pins, and pin values, one bit per pin. Empty to add
+     *                 pins to the callback already registered.
+     * @return bool true command accepted by location, false location not
+     *         found, a callback is already registered or none to add to.
+     */
+    bool enablePortInterrupt(uint32_t mask, uint16_t location,
+                             FunctionPointer3<void, uint16_t, uint32_t, uint32_t> callback);
+
+    /**
+     * @brief Disable interrupts enabled with enablePortInterrupt.
+     * @details Pins with a per-pin callback or tracked with trackInput keep
+     *          their interrupt enabled. The location leaves batched mode when
+     *          no port interrupt pins are left.
+     *
+     * @param mask Bit mask selecting the pins to disable.
+     * @param location Address for external I/O device. For I2C devices,
+     *                 the I2C address is the location.
+     * @return bool true command accepted by location, false location not found.
+     */
+    bool disablePortInterrupt(uint32_t mask, uint16_t location);
+
+    /**
+     * @brief Debounce interrupts on pin at location.
+     * @details Edges reported by the device are filtered before the callback
+     *          registered with enableInterrupt is called. The number of pins
+     *          that can be debounced is set by wrd-gpio-switch.debounce-slots.
+     *
+     * @param pin Zero indexed pin number.
+     * @param location Address for external I/O device. For I2C devices,
+     *                 the I2C address is the location.
+     * @param mode Debounce mode, DEBOUNCE_NONE to remove debouncing.
+     * @param time Debounce time in milliseconds.
+     * @return bool true debounce set, false location not found or no free slot.
+     */
+    bool setDebounce(uint8_t pin, uint16_t location, debounce_t mode, uint16_t time);
+
+    /**
+     * @brief Keep the value of an input pin up to date through interrupts.
+     * @details Enables the interrupt on the pin and reads the initial value.
+     *          Once that read has completed, readInputCached returns the
+     *          current value without any bus traffic. On expanders without
+     *          an interrupt pin the value is updated by the periodic scan.
+     *          Tracking stops when disableInterrupt is called for the pin.
+     *
+     * @param pin Zero indexed pin number.
+     * @param location Address for external I/O device. For I2C devices,
+     *                 the I2C address is the location.
+     * @return bool true pin is tracked, false location not found or queue
+     *         full.
+     */
+    bool trackInput(uint8_t pin, uint16_t location);
+
+    /**
+     * @brief Read input pin value from the shadow register.
+     * @details Each location keeps a shadow of its input pins, refreshed by
+     *          every read and by pin changes reported through interrupts.
+     *          No command is sent to the device.
+     *
+     * @param pin Zero indexed pin number.
+     * @param location Address for external I/O device. For I2C devices,
+     *                 the I2C address is the location.
+     * @param maxAge Accept values read at most this many milliseconds ago.
+     *               With 0, only pins tracked with trackInput are returned.
+     * @return pin value. 0 is low, 1 is high, -1 if pin is not tracked (or
+     *         its first read has not completed) and the shadow is older
+     *         than maxAge.
+     */
+    int readInputCached(uint8_t pin, uint16_t location, uint32_t maxAge = 0);
+
+    /**
+     * @brief Get the input shadow register for location.
+     *
+     * @param location Address for external I/O device. For I2C devices,
+     *                 the I2C address is the location.
+     * @param values Pin values, one bit per pin.
+     * @param timestamp MINAR time when the values were last read.
+     * @return bool true values copied, false location not found or not read yet.
+     */
+    bool getInputShadow(uint16_t location, uint32_t& values, minar::tick_t& timestamp);
+
+    /**
+     * @brief Send the output, direction and interrupt state again.
+     * @details GPIOSwitch keeps a shadow of the state sent to each device
+     *          and does not send commands that would not change it. Call
+     *          this after the device has been reset, so the shadowed state
+     *          is written to the device and the shadow is trusted again.
+     *
+     * @param location Address for external I/O device. For I2C devices,
+     *                 the I2C address is the location.
+     * @return bool true commands accepted by location, false location not found or queue full.
+     */
+    bool resynchronize(uint16_t location);
+
+    /**
+     * @brief Get snapshot of counters for location.
+     *
+     * @param location Address for external I/O device. For I2C devices,
+     *                 the I2C address is the location.
+     * @param statistics Struct to copy counters into.
+     * @return bool true counters copied, false location not found or
+     *         statistics disabled.
+     */
+    bool getStatistics(uint16_t location, statistics_t& statistics);
+
+    /**
+     * @brief Reset counters for location.
+     *
+     * @param location Address for external I/O device. For I2C devices,
+     *                 the I2C address is the location.
+     * @return bool true counters reset, false location not found or
+     *         statistics disabled.
+     */
+    bool resetStatistics(uint16_t location);
 }
 
 #endif // __WRD_GPIO_SWITCH_H__
@@ -19,7 +19,7 @@
 #define __WRD_GPIO_INTERRUPT_IN_EX_H__
 
 #include "mbed-drivers/mbed.h"
-#include "core-util/SharedPointer.h"
+#include "wrd-gpio-switch/GPIOSwitch.h"
 
 using namespace mbed::util;
 
@@ -28,6 +28,11 @@ class InterruptInEx
 public:
     InterruptInEx(uint32_t pin, uint32_t location = 0);
 
+    /**
+     * @brief Disable interrupts and release the pin.
+     */
+    ~InterruptInEx();
+
     /**
      * @brief Read pin value.
      * @return Pin value, high 1, low 0
@@ -54,7 +59,7 @@ public:
         }
         else
         {
-            local->rise(callback);
+            local()->rise(callback);
         }
     }
 
@@ -74,7 +79,7 @@ public:
         }
         else
         {
-            local->rise(object, member);
+            local()->rise(object, member);
         }
     }
 
@@ -92,7 +97,7 @@ public:
         }
         else
         {
-            local->fall(callback);
+            local()->fall(callback);
         }
     }
 
@@ -112,7 +117,7 @@ public:
         }
         else
         {
-            local->fall(object, member);
+            local()->fall(object, member);
         }
     }
 
@@ -137,8 +142,23 @@ public:
      */
     void disable_irq();
 
+    /**
+     * @brief Filter contact bounce before rise and fall callbacks are called.
+     * @details Only supported for pins on external I/O devices. See
+     *          GPIOSwitch::setDebounce for the available modes. Debouncing
+     *          is removed by disable_irq and when the object is destroyed.
+     *
+     * @param mode Debounce mode, DEBOUNCE_NONE to remove debouncing.
+     * @param time Debounce time in milliseconds.
+     * @return bool true debounce set, false not supported or no free slot.
+     */
+    bool setDebounce(GPIOSwitch::debounce_t mode, uint16_t time);
 
 private:
+    /* the interrupt callbacks refer to this object, so it cannot be copied */
+    InterruptInEx(const InterruptInEx&);
+    InterruptInEx& operator=(const InterruptInEx&);
+
     void internalRise(FunctionPointer0<void>);
     void internalFall(FunctionPointer0<void>);
 
@@ -146,7 +166,17 @@ private:
 
     uint32_t pin;
     uint32_t location;
-    SharedPointer<InterruptIn> local;
+
+    /* InterruptIn for pins on the main MCU, constructed in place so no heap
+       allocation is needed.
+    */
+    alignas(InterruptIn) uint8_t localStorage[sizeof(InterruptIn)];
+
+    InterruptIn* local(void)
+    {
+        return reinterpret_cast<InterruptIn*>(localStorage);
+    }
+
     int value;
     FunctionPointer0<void> riseCallback;
     FunctionPointer0<void> fallCallback;
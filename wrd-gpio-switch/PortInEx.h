@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __WRD_GPIO_PORT_IN_EX_H__
+#define __WRD_GPIO_PORT_IN_EX_H__
+
+#include "mbed-drivers/mbed.h"
+#include "wrd-gpio-switch/GPIOSwitch.h"
+
+using namespace mbed::util;
+
+class PortInEx
+{
+public:
+    /**
+     * @brief Create a PortInEx connected to the pins selected by mask.
+     * @details The location specifies which I/O expander the pins are on.
+     *          For I2C I/O expanders, the location is the I2C address.
+     *          All selected pins are configured as inputs.
+     *
+     * @param location port location.
+     * @param mask bit mask selecting which pins are part of the port.
+     */
+    PortInEx(uint32_t location, uint32_t mask = 0xFFFFFFFF);
+
+    /**
+     * @brief Read the value of the port.
+     * @details A cached value is returned immediately and a new value is
+     *          fetched into the cache. When possible, the asynchronous API
+     *          should be used.
+     *
+     * @return An integer with one bit per pin, masked by the port mask.
+     */
+    int read(void);
+
+    /**
+     * @brief Read the value of the port.
+     * @details The value is returned in the callback function, one bit per pin,
+     *          masked by the port mask. All pins are read in a single
+     *          bus transaction.
+     *
+     * @param callback Function to call with the port value.
+     * @param priority Queue priority for commands to external I/O devices.
+     */
+    void read(FunctionPointer1<void, uint32_t> callback,
+              GPIOSwitch::priority_t priority = GPIOSwitch::PRIORITY_NORMAL);
+
+#ifdef MBED_OPERATORS
+    /**
+     * @brief A shorthand for read().
+     */
+    operator int()
+    {
+        return read();
+    }
+#endif
+
+private:
+    void updateCache(uint32_t);
+
+    uint32_t location;
+    uint32_t mask;
+    uint32_t cache;
+};
+
+#endif // __WRD_GPIO_PORT_IN_EX_H__
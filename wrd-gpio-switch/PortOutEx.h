@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __WRD_GPIO_PORT_OUT_EX_H__
+#define __WRD_GPIO_PORT_OUT_EX_H__
+
+#include "mbed-drivers/mbed.h"
+#include "wrd-gpio-switch/GPIOSwitch.h"
+
+using namespace mbed::util;
+
+class PortOutEx
+{
+public:
+
+    /**
+     * @brief Create a PortOutEx connected to the pins selected by mask.
+     * @details The location specifies which I/O expander the pins are on.
+     *          For I2C I/O expanders, the location is the I2C address.
+     *          All selected pins are set low and configured as outputs.
+     *
+     * @param location port location.
+     * @param mask bit mask selecting which pins are part of the port.
+     */
+    PortOutEx(uint32_t location, uint32_t mask = 0xFFFFFFFF);
+
+    /**
+     * @brief Return the output setting of the port.
+     * @return An integer representing the output setting of the pins,
+     *         one bit per pin, masked by the port mask.
+     */
+    int read();
+
+    /**
+     * @brief Set the output of all pins in the port.
+     * @details All pins are updated in a single bus transaction.
+     *          Unlike DigitalOutEx, this call is not safe from interrupt context.
+     *
+     * @param value An integer specifying the pin output values, one bit per pin.
+     *              Bits not in the port mask are ignored.
+     */
+    void write(int value);
+
+    /**
+     * @brief Set the output of all pins in the port.
+     * @details All pins are updated in a single bus transaction.
+     *          The callback can be used to chain operations.
+     *
+     * @param value An integer specifying the pin output values, one bit per pin.
+     *              Bits not in the port mask are ignored.
+     * @param callback The function to call once the new value has been applied.
+     * @param priority Queue priority for commands to external I/O devices.
+     */
+    void write(int value, FunctionPointer0<void> callback,
+               GPIOSwitch::priority_t priority = GPIOSwitch::PRIORITY_NORMAL);
+
+    /**
+     * @brief Set the output of all pins in the port.
+     * @details All pins are updated in a single bus transaction.
+     *          The callback can be used to chain operations.
+     *
+     * @param value An integer specifying the pin output values, one bit per pin.
+     *              Bits not in the port mask are ignored.
+     * @param object Pointer to object to perform callback on.
+     * @param member Pointer to member function in object.
+     */
+    template <typename T>
+    void write(int value, T* object, void (T::*member)(void))
+    {
+        FunctionPointer0<void> fp(object, member);
+        write(value, fp);
+    }
+
+#ifdef MBED_OPERATORS
+    /**
+     * @brief A shorthand for read().
+     */
+    operator int()
+    {
+        return read();
+    }
+
+    /**
+     * @brief A shorthand for write().
+     */
+    PortOutEx& operator=(int value)
+    {
+        write(value);
+        return *this;
+    }
+
+    /**
+     * @brief Assignment operator.
+     */
+    PortOutEx& operator=(PortOutEx& rhs)
+    {
+        write(rhs.read());
+        return *this;
+    }
+#endif
+
+private:
+    uint32_t location;
+    uint32_t mask;
+};
+
+#endif // __WRD_GPIO_PORT_OUT_EX_H__
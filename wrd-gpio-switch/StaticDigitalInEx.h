@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __WRD_GPIO_STATIC_DIGITAL_IN_EX_H__
+#define __WRD_GPIO_STATIC_DIGITAL_IN_EX_H__
+
+#include "mbed-drivers/mbed.h"
+#include "wrd-gpio-switch/GPIOSwitch.h"
+
+using namespace mbed::util;
+
+/**
+ * @brief DigitalInEx with the location fixed at compile time.
+ * @details The location selects the implementation when the program is
+ *          compiled, so no branch on the location is taken at runtime.
+ *          Pins on external I/O devices call GPIOSwitch directly, and pins on
+ *          the main MCU (location 0) use the HAL directly without a heap
+ *          allocated DigitalIn.
+ *
+ * @tparam LOCATION digital pin location. The main MCU is location 0.
+ *                  For I2C I/O expanders, the location is the I2C address.
+ */
+template <uint32_t LOCATION>
+class StaticDigitalInEx
+{
+public:
+    /**
+     * @brief Create a StaticDigitalInEx connected to the pin.
+     *
+     * @param _pin digital pin to connect to.
+     */
+    StaticDigitalInEx(uint32_t _pin)
+        :   pin(_pin),
+            cache(0)
+    {
+        GPIOSwitch::configureInput(pin, LOCATION);
+    }
+
+    /**
+     * @brief Read the input, represented as 0 or 1 (int)
+     * @details Pins tracked with track() return the current value. Otherwise
+     *          a cached value is returned immediately and a new value is
+     *          fetched into the cache.
+     *
+     * @return An integer representing the state of the input pin,
+     *         0 for logical 0, 1 for logical 1
+     */
+    int read(void)
+    {
+        int value = GPIOSwitch::readInputCached(pin, LOCATION);
+
+        if (value < 0)
+        {
+            // schedule cache to be updated
+            FunctionPointer1<void, int> fp(this, &StaticDigitalInEx::updateCache);
+            GPIOSwitch::readInput(pin, LOCATION, fp);
+
+            value = cache;
+        }
+
+        return value;
+    }
+
+    /**
+     * @brief Read the input, represented as 0 or 1 (int)
+     * @details The value is returned in the callback function.
+     *
+     * @param callback Function to call with the pin value.
+     * @param priority Queue priority for the command.
+     */
+    void read(FunctionPointer1<void, int> callback,
+              GPIOSwitch::priority_t priority = GPIOSwitch::PRIORITY_NORMAL)
+    {
+        GPIOSwitch::readInput(pin, LOCATION, callback, priority);
+    }
+
+    /**
+     * @brief Keep the input value up to date through interrupts.
+     * @details See DigitalInEx::track.
+     *
+     * @return bool true the value is tracked, false read() polls the device.
+     */
+    bool track(void)
+    {
+        return GPIOSwitch::trackInput(pin, LOCATION);
+    }
+
+#ifdef MBED_OPERATORS
+    /**
+     * @brief A shorthand for read().
+     */
+    operator int()
+    {
+        return read();
+    }
+#endif
+
+private:
+    void updateCache(int value)
+    {
+        cache = value;
+    }
+
+    uint8_t pin;
+    int8_t cache;
+};
+
+/**
+ * @brief StaticDigitalInEx for pins on the main MCU.
+ * @details Wraps a gpio_t, so read compiles to the HAL call used by DigitalIn.
+ */
+template <>
+class StaticDigitalInEx<0>
+{
+public:
+    /**
+     * @brief Create a StaticDigitalInEx connected to the pin.
+     *
+     * @param pin digital pin to connect to.
+     */
+    StaticDigitalInEx(uint32_t pin)
+    {
+        gpio_init_in(&gpio, (PinName) pin);
+    }
+
+    /**
+     * @brief Create a StaticDigitalInEx connected to the pin.
+     *
+     * @param pin digital pin to connect to.
+     * @param mode the initial mode of the pin.
+     */
+    StaticDigitalInEx(uint32_t pin, PinMode mode)
+    {
+        gpio_init_in_ex(&gpio, (PinName) pin, mode);
+    }
+
+    /**
+     * @brief Read the input, represented as 0 or 1 (int)
+     *
+     * @return An integer representing the state of the input pin,
+     *         0 for logical 0, 1 for logical 1
+     */
+    int read(void)
+    {
+        return gpio_read(&gpio);
+    }
+
+    /**
+     * @brief Read the input, represented as 0 or 1 (int)
+     * @details The pin is read immediately and the value is passed to the
+     *          callback through MINAR.
+     *
+     * @param callback Function to call with the pin value.
+     * @param priority Unused for pins on the main MCU.
+     */
+    void read(FunctionPointer1<void, int> callback,
+              GPIOSwitch::priority_t priority = GPIOSwitch::PRIORITY_NORMAL)
+    {
+        (void) priority;
+
+        minar::Scheduler::postCallback(callback.bind(gpio_read(&gpio)))
+            .tolerance(1);
+    }
+
+    /**
+     * @brief Set the input pin mode.
+     * @param pull PullUp, PullDown, PullNone, OpenDrain
+     */
+    void mode(PinMode pull)
+    {
+        gpio_mode(&gpio, pull);
+    }
+
+#ifdef MBED_OPERATORS
+    /**
+     * @brief A shorthand for read().
+     */
+    operator int()
+    {
+        return read();
+    }
+#endif
+
+private:
+    gpio_t gpio;
+};
+
+#endif // __WRD_GPIO_STATIC_DIGITAL_IN_EX_H__
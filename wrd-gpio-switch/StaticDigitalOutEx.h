@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __WRD_GPIO_STATIC_DIGITAL_OUT_EX_H__
+#define __WRD_GPIO_STATIC_DIGITAL_OUT_EX_H__
+
+#include "mbed-drivers/mbed.h"
+#include "wrd-gpio-switch/GPIOSwitch.h"
+
+using namespace mbed::util;
+
+/**
+ * @brief DigitalOutEx with the location fixed at compile time.
+ * @details The location selects the implementation when the program is
+ *          compiled, so no branch on the location is taken at runtime.
+ *          Pins on external I/O devices call GPIOSwitch directly, and pins on
+ *          the main MCU (location 0) use the HAL directly without a heap
+ *          allocated DigitalOut.
+ *
+ * @tparam LOCATION digital pin location. The main MCU is location 0.
+ *                  For I2C I/O expanders, the location is the I2C address.
+ */
+template <uint32_t LOCATION>
+class StaticDigitalOutEx
+{
+public:
+    /**
+     * @brief Create a StaticDigitalOutEx connected to the pin.
+     *
+     * @param _pin digital pin to connect to.
+     * @param value pin out, 1 high, 0 low.
+     */
+    StaticDigitalOutEx(uint32_t _pin, int value = 0)
+        :   pin(_pin)
+    {
+        GPIOSwitch::configureOutput(pin, LOCATION, value);
+    }
+
+    /**
+     * @brief Return the output setting, represented as 0 or 1 (int).
+     * @return An integer representing the output setting of the pin,
+     *         0 for logical 0, 1 for logical 1
+     */
+    int read()
+    {
+        return GPIOSwitch::readOutput(pin, LOCATION);
+    }
+
+    /**
+     * @brief Set the output, specified as 0 or 1 (int).
+     * @details Commands are queued up and processed sequentially.
+     *
+     * @param value An integer specifying the pin output value, 0 for logical 0,
+     *              1 (or any other non-zero value) for logical 1.
+     */
+    void write(int value)
+    {
+        GPIOSwitch::writeOutputIrq(pin, LOCATION, value);
+    }
+
+    /**
+     * @brief Set the output, specified as 0 or 1 (int).
+     * @details The callback can be used to chain operations.
+     *
+     * @param value An integer specifying the pin output value, 0 for logical 0,
+     *              1 (or any other non-zero value) for logical 1.
+     * @param callback The function to call once the new value has been applied.
+     * @param priority Queue priority for the command.
+     */
+    void write(int value, FunctionPointer0<void> callback,
+               GPIOSwitch::priority_t priority = GPIOSwitch::PRIORITY_NORMAL)
+    {
+        GPIOSwitch::writeOutput(pin, LOCATION, value, callback, priority);
+    }
+
+#ifdef MBED_OPERATORS
+    /**
+     * @brief A shorthand for read().
+     */
+    operator int()
+    {
+        return read();
+    }
+
+    /**
+     * @brief A shorthand for write().
+     */
+    StaticDigitalOutEx& operator=(int value)
+    {
+        write(value);
+        return *this;
+    }
+#endif
+
+private:
+    uint8_t pin;
+};
+
+/**
+ * @brief StaticDigitalOutEx for pins on the main MCU.
+ * @details Wraps a gpio_t, so read and write compile to the HAL calls used
+ *          by DigitalOut.
+ */
+template <>
+class StaticDigitalOutEx<0>
+{
+public:
+    /**
+     * @brief Create a StaticDigitalOutEx connected to the pin.
+     *
+     * @param pin digital pin to connect to.
+     * @param value pin out, 1 high, 0 low.
+     */
+    StaticDigitalOutEx(uint32_t pin, int value = 0)
+    {
+        gpio_init_out_ex(&gpio, (PinName) pin, value);
+    }
+
+    /**
+     * @brief Return the output setting, represented as 0 or 1 (int).
+     * @return An integer representing the output setting of the pin,
+     *         0 for logical 0, 1 for logical 1
+     */
+    int read()
+    {
+        return gpio_read(&gpio);
+    }
+
+    /**
+     * @brief Set the output, specified as 0 or 1 (int).
+     *
+     * @param value An integer specifying the pin output value, 0 for logical 0,
+     *              1 (or any other non-zero value) for logical 1.
+     */
+    void write(int value)
+    {
+        gpio_write(&gpio, value);
+    }
+
+    /**
+     * @brief Set the output, specified as 0 or 1 (int).
+     * @details The output is set immediately and the callback is posted
+     *          through MINAR.
+     *
+     * @param value An integer specifying the pin output value, 0 for logical 0,
+     *              1 (or any other non-zero value) for logical 1.
+     * @param callback The function to call once the new value has been applied.
+     * @param priority Unused for pins on the main MCU.
+     */
+    void write(int value, FunctionPointer0<void> callback,
+               GPIOSwitch::priority_t priority = GPIOSwitch::PRIORITY_NORMAL)
+    {
+        (void) priority;
+
+        gpio_write(&gpio, value);
+        minar::Scheduler::postCallback(callback)
+            .tolerance(1);
+    }
+
+#ifdef MBED_OPERATORS
+    /**
+     * @brief A shorthand for read().
+     */
+    operator int()
+    {
+        return read();
+    }
+
+    /**
+     * @brief A shorthand for write().
+     */
+    StaticDigitalOutEx& operator=(int value)
+    {
+        write(value);
+        return *this;
+    }
+#endif
+
+private:
+    gpio_t gpio;
+};
+
+#endif // __WRD_GPIO_STATIC_DIGITAL_OUT_EX_H__